@@ -0,0 +1,68 @@
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/array.hpp>
+#include <cereal/types/bitset.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/queue.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/archives/binary.hpp>
+
+#include "Board.h"
+#include "Boards.h"
+#include "EngineRun.h"
+#include "Play.h"
+#include "PlayBidirectional.h"
+#include "RandomBoard.h"
+#include "SearchOptions.h"
+
+/*
+	Compares --engine bidirectional with bfs on the classic board and on scaled-up random variants of it: 8% trees, the penguin and the target in opposite corners.
+	Both times include building the board, for bfs with its stop cell graph and for bidirectional without. Fails if the two disagree on the number of moves.
+*/
+
+static constexpr double SCALED_TREE_DENSITY = 0.08;
+
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS>
+bool compareOn(std::string const& name, std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections) {
+	SearchOptions options;
+	options.noBackups = true;
+	std::size_t const stopCellCount = Board<NUM_ROWS, NUM_COLS, false, 0>::fromFieldString(fieldString, holeConnections).first.getStopCellCount();
+	EngineRun const bfs = runEngine([&]() {
+		return play<NUM_ROWS, NUM_COLS, false, 0>(fieldString, holeConnections, options);
+	});
+	EngineRun const bidirectional = runEngine([&]() {
+		return playBidirectional<NUM_ROWS, NUM_COLS, false, 0>(fieldString, holeConnections, options);
+	});
+
+	std::cout << name << ": " << stopCellCount << " stop cells, bfs " << bfs.moves.size() << " moves in " << bfs.milliseconds << " ms, bidirectional " << bidirectional.moves.size() << " moves in " << bidirectional.milliseconds << " ms with " << bidirectional.result << " cells expanded." << std::endl;
+	if ((bfs.hasSolution != bidirectional.hasSolution) || (bfs.moves.size() != bidirectional.moves.size())) {
+		std::cerr << name << ": bfs found '" << bfs.moves << "', but bidirectional found '" << bidirectional.moves << "'!" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+template<std::size_t SIZE>
+bool compareOnScaled(std::uint64_t const& seed) {
+	RandomBoard<SIZE, SIZE> board(seed, SCALED_TREE_DENSITY, false);
+	board.place('P', 1, 1);
+	board.place('X', SIZE - 2, SIZE - 2);
+	return compareOn<SIZE, SIZE>(std::to_string(SIZE) + "x" + std::to_string(SIZE), board.getFieldString(), board.getHoleConnections());
+}
+
+int main(int argc, char* argv[]) {
+	std::uint64_t const seed = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1;
+	std::cout << "Random boards with seed " << seed << "." << std::endl;
+
+	bool isSuccess = compareOn<20, 20>("classic 20x20", fieldStringBasic, holeConnectionsBasic);
+	isSuccess = compareOnScaled<100>(seed) && isSuccess;
+	isSuccess = compareOnScaled<300>(seed) && isSuccess;
+	isSuccess = compareOnScaled<1000>(seed) && isSuccess;
+	return isSuccess ? 0 : -1;
+}
@@ -0,0 +1,206 @@
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/array.hpp>
+#include <cereal/types/bitset.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/queue.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/archives/binary.hpp>
+
+#include "Board.h"
+#include "DenseVisitedSet.h"
+#include "EngineRun.h"
+#include "Play.h"
+#include "PlayAStar.h"
+#include "PlayBeam.h"
+#include "PlayBranchAndBound.h"
+#include "PlayIdaStar.h"
+#include "PlayMeetInTheMiddle.h"
+#include "PlayNonOptimal.h"
+#include "PlayTablebase.h"
+#include "RandomBoard.h"
+#include "SearchOptions.h"
+
+/*
+	Checks every engine against bfs on random torus boards with presents and holes.
+	The optimal engines have to find a solution of the same length as bfs, 'beam' and 'greedy' one at least as long, and every solution
+	is replayed slide by slide on the board, independent of the stop cell graph the engines search, and has to end on a target with all presents collected.
+	The pattern databases of 'astar', 'idastar', 'bnb' and 'beam' are cached in the working directory, so better run it in an empty one.
+*/
+
+static std::string const TABLEBASE_FILENAME = "EngineAgreement.tablebase";
+
+struct EngineCheck {
+public:
+	std::string name;
+	bool isOptimal;
+	std::function<std::size_t()> run;
+};
+
+template<Direction DIR, std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+bool slide(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::size_t& pos, PresentOverlayView<NUM_ROWS, NUM_COLS, PRESENT_COUNT>& presents) {
+	std::size_t target = 0;
+	if (!board.template canMoveInDir<DIR>(pos, target)) {
+		return false;
+	}
+	pos = board.template moveInDir<DIR>(pos, presents);
+	return true;
+}
+
+// Whether the moves end on a target with all presents collected, every slide moving the penguin and none of them starting on a target.
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+bool isSolution(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, std::string const& moves) {
+	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections);
+	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board = init.first;
+	PresentOverlayView<NUM_ROWS, NUM_COLS, PRESENT_COUNT> presents = init.second.getView();
+	std::size_t pos = board.getPenguinStartingPosition();
+	for (auto it = moves.cbegin(); it != moves.cend(); ++it) {
+		if (board.getPieceAt(pos) == BoardPiece::TARGET) {
+			return false;
+		}
+		bool hasMoved = false;
+		switch (*it) {
+			case 'U':
+				hasMoved = slide<Direction::UP>(board, pos, presents);
+				break;
+			case 'D':
+				hasMoved = slide<Direction::DOWN>(board, pos, presents);
+				break;
+			case 'L':
+				hasMoved = slide<Direction::LEFT>(board, pos, presents);
+				break;
+			case 'R':
+				hasMoved = slide<Direction::RIGHT>(board, pos, presents);
+				break;
+			default:
+				break;
+		}
+		if (!hasMoved) {
+			return false;
+		}
+	}
+	return (board.getPieceAt(pos) == BoardPiece::TARGET) && (presents.getPresentsLeft() == 0);
+}
+
+// Returns the number of engines that disagree with bfs or give an invalid solution.
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, std::size_t PRESENT_COUNT>
+std::size_t checkBoard(std::string const& name, RandomBoard<NUM_ROWS, NUM_COLS> const& randomBoard, std::size_t const& threadCount) {
+	std::array<std::string, NUM_ROWS> const& fieldString = randomBoard.getFieldString();
+	std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections = randomBoard.getHoleConnections();
+
+	SearchOptions options;
+	options.noBackups = true;
+	options.transpositionTableMemory = std::uint64_t(64) * 1024 * 1024;
+	options.tablebaseFilename = TABLEBASE_FILENAME;
+	SearchOptions threads = options;
+	threads.threadCount = threadCount;
+	SearchOptions endgame = options;
+	endgame.endgamePresentCount = 3;
+	SearchOptions greedyBound = options;
+	greedyBound.useGreedyBound = true;
+	SearchOptions presentDistances = options;
+	presentDistances.heuristic = HeuristicType::PRESENT_DISTANCES;
+
+	std::vector<EngineCheck> const checks = {
+		{ "bfs --threads " + std::to_string(threadCount), true, [&]() { return play<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, threads); } },
+		{ "bfs --visited dense", true, [&]() { return play<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT, DenseVisitedSet<PRESENT_COUNT>>(fieldString, holeConnections, options); } },
+		{ "bfs --endgame 3", true, [&]() { return play<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, endgame); } },
+		{ "bfs --greedyBound", true, [&]() { return play<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, greedyBound); } },
+		{ "astar", true, [&]() { return playAStar<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, options); } },
+		{ "astar --heuristic presents", true, [&]() { return playAStar<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, presentDistances); } },
+		{ "idastar", true, [&]() { return playIdaStar<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, options); } },
+		{ "bnb --threads " + std::to_string(threadCount), true, [&]() { return playBranchAndBound<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, threads); } },
+		{ "mitm", true, [&]() { return playMeetInTheMiddle<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, options); } },
+		{ "tablebase", true, [&]() { return playTablebase<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, options); } },
+		{ "beam", false, [&]() { return playBeam<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, options); } },
+		{ "greedy", false, [&]() { return playNonOptimal<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, options); } }
+	};
+
+	EngineRun const reference = runEngine([&]() {
+		return play<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, options);
+	});
+	if (reference.hasSolution && !isSolution<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, reference.moves)) {
+		std::cerr << name << ": bfs found '" << reference.moves << "', which is no solution!" << std::endl;
+		return 1;
+	}
+
+	std::size_t failureCount = 0;
+	for (auto it = checks.cbegin(); it != checks.cend(); ++it) {
+		EngineRun const run = runEngine(it->run);
+		bool isValid = run.hasSolution == reference.hasSolution;
+		if (isValid && run.hasSolution) {
+			isValid = (it->isOptimal ? (run.moves.size() == reference.moves.size()) : (run.moves.size() >= reference.moves.size())) && isSolution<NUM_ROWS, NUM_COLS, true, PRESENT_COUNT>(fieldString, holeConnections, run.moves);
+		}
+		// The heuristic engines may miss a solution bfs finds, but never find one where bfs does not
+		if (!it->isOptimal && !run.hasSolution) {
+			isValid = true;
+		}
+		if (!isValid) {
+			std::cerr << name << ": '" << it->name << "' found '" << run.moves << "', but bfs found '" << reference.moves << "'!" << std::endl;
+			++failureCount;
+		}
+	}
+	std::filesystem::remove(TABLEBASE_FILENAME);
+
+	if (reference.hasSolution) {
+		std::cout << name << ": " << reference.moves.size() << " moves in " << reference.milliseconds << " ms with bfs, " << (checks.size() - failureCount) << " of " << checks.size() << " engines agree." << std::endl;
+	} else {
+		std::cout << name << ": no solution, " << (checks.size() - failureCount) << " of " << checks.size() << " engines agree." << std::endl;
+	}
+	return failureCount;
+}
+
+// 12x12 boards with 5 to 7 presents and every other one with 3 holes, 18% trees.
+std::size_t checkSmallBoard(std::uint64_t const& seed, std::size_t const& threadCount) {
+	RandomBoard<12, 12> board(seed, 0.18, true);
+	board.place('P');
+	board.place('X');
+	for (std::size_t i = 0; i < 5 + (seed % 3); ++i) {
+		board.place('$');
+	}
+	board.placeHoles((seed % 2) * 3);
+	return checkBoard<12, 12, 8>("small #" + std::to_string(seed), board, threadCount);
+}
+
+// 24x24 boards with 20 presents and 2 holes, 18% trees.
+std::size_t checkLargeBoard(std::uint64_t const& seed, std::size_t const& threadCount) {
+	RandomBoard<24, 24> board(seed, 0.18, true);
+	board.place('P');
+	board.place('X');
+	for (std::size_t i = 0; i < 20; ++i) {
+		board.place('$');
+	}
+	board.placeHoles(2);
+	return checkBoard<24, 24, 20>("large #" + std::to_string(seed), board, threadCount);
+}
+
+void printHelp() {
+	std::cerr << "Usage:" << std::endl;
+	std::cerr << "EngineAgreement [small|large] [BOARDS] [FIRST SEED] [THREADS]: Checks all engines against bfs on BOARDS random boards, default is small 12x12 boards, 40 of them from seed 1 and 4 threads." << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	std::string const size = (argc > 1) ? argv[1] : "small";
+	std::size_t const boardCount = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 40;
+	std::uint64_t const firstSeed = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 1;
+	std::size_t const threadCount = (argc > 4) ? std::strtoull(argv[4], nullptr, 10) : 4;
+	if (((size.compare("small") != 0) && (size.compare("large") != 0)) || (boardCount == 0) || (threadCount == 0)) {
+		printHelp();
+		return -1;
+	}
+
+	std::size_t failureCount = 0;
+	for (std::uint64_t seed = firstSeed; seed < firstSeed + boardCount; ++seed) {
+		failureCount += (size.compare("small") == 0) ? checkSmallBoard(seed, threadCount) : checkLargeBoard(seed, threadCount);
+	}
+	std::cout << "Checked " << boardCount << " boards, " << failureCount << " disagreements." << std::endl;
+	return (failureCount == 0) ? 0 : -1;
+}
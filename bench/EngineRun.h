@@ -0,0 +1,52 @@
+#ifndef ENGINERUN_H_
+#define ENGINERUN_H_
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/*
+	The outcome of an engine in runEngine(): its moves, empty if it found none, the count it returns, e.g. the expanded states, and its time including building the board.
+*/
+struct EngineRun {
+public:
+	EngineRun() : hasSolution(false), moves(""), result(0), milliseconds(0) {
+		//
+	}
+
+	bool hasSolution;
+	std::string moves;
+	std::size_t result;
+	std::int64_t milliseconds;
+};
+
+/*
+	Runs engine() with its output swallowed and takes the moves from the last line every engine prints for its solution.
+*/
+template<typename ENGINE>
+EngineRun runEngine(ENGINE const& engine) {
+	static std::string const solutionPrefix = "Terminating search, found a solution collecting all presents: ";
+
+	std::ostringstream output;
+	std::streambuf* const previousBuffer = std::cout.rdbuf(output.rdbuf());
+	auto const begin = std::chrono::steady_clock::now();
+	EngineRun run;
+	run.result = engine();
+	auto const end = std::chrono::steady_clock::now();
+	std::cout.rdbuf(previousBuffer);
+	run.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+
+	std::istringstream lines(output.str());
+	std::string line;
+	while (std::getline(lines, line)) {
+		if (line.compare(0, solutionPrefix.size(), solutionPrefix) == 0) {
+			run.hasSolution = true;
+			run.moves = line.substr(solutionPrefix.size());
+		}
+	}
+	return run;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef RANDOMBOARD_H_
+#define RANDOMBOARD_H_
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+	A random board in the format of Board::fromFieldString() for the benchmarks: trees with the given density and a wall around it unless it is a torus.
+	On a torus, every row and column gets at least one tree, so no slide goes on forever. The pieces are then placed on empty cells, see place().
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS>
+class RandomBoard {
+public:
+	RandomBoard(std::uint64_t const& seed, double const& treeDensity, bool const& isTorus) : m_random(seed), m_fieldString(), m_holeConnections() {
+		std::uniform_real_distribution<double> chance(0.0, 1.0);
+		for (std::size_t row = 0; row < NUM_ROWS; ++row) {
+			m_fieldString[row] = std::string(NUM_COLS, ' ');
+			for (std::size_t col = 0; col < NUM_COLS; ++col) {
+				if (!isTorus && ((row == 0) || (row == NUM_ROWS - 1) || (col == 0) || (col == NUM_COLS - 1))) {
+					m_fieldString[row][col] = '#';
+				} else if (chance(m_random) < treeDensity) {
+					m_fieldString[row][col] = 'T';
+				}
+			}
+		}
+		if (isTorus) {
+			for (std::size_t row = 0; row < NUM_ROWS; ++row) {
+				if (m_fieldString[row].find('T') == std::string::npos) {
+					m_fieldString[row][getRandomIndex(NUM_COLS)] = 'T';
+				}
+			}
+			for (std::size_t col = 0; col < NUM_COLS; ++col) {
+				bool hasTree = false;
+				for (std::size_t row = 0; !hasTree && (row < NUM_ROWS); ++row) {
+					hasTree = m_fieldString[row][col] == 'T';
+				}
+				if (!hasTree) {
+					m_fieldString[getRandomIndex(NUM_ROWS)][col] = 'T';
+				}
+			}
+		}
+	}
+	~RandomBoard() {
+		//
+	}
+
+	// Puts the piece on the given cell, which has to be inside the wall.
+	void place(char const& piece, std::size_t const& row, std::size_t const& col) {
+		m_fieldString[row][col] = piece;
+	}
+
+	// Puts the piece on a random empty cell and returns its position.
+	std::size_t place(char const& piece) {
+		while (true) {
+			std::size_t const row = getRandomIndex(NUM_ROWS);
+			std::size_t const col = getRandomIndex(NUM_COLS);
+			if (m_fieldString[row][col] == ' ') {
+				m_fieldString[row][col] = piece;
+				return row * NUM_COLS + col;
+			}
+		}
+	}
+
+	// Puts holeCount holes on random empty cells, each one leading to the next and the last one back to the first.
+	void placeHoles(std::size_t const& holeCount) {
+		std::vector<std::size_t> holes;
+		for (std::size_t i = 0; i < holeCount; ++i) {
+			holes.push_back(place('O'));
+		}
+		for (std::size_t i = 0; i < holeCount; ++i) {
+			m_holeConnections.push_back(std::make_pair(holes[i], holes[(i + 1) % holeCount]));
+		}
+	}
+
+	inline std::array<std::string, NUM_ROWS> const& getFieldString() const noexcept(true) {
+		return m_fieldString;
+	}
+
+	inline std::vector<std::pair<std::size_t, std::size_t>> const& getHoleConnections() const noexcept(true) {
+		return m_holeConnections;
+	}
+private:
+	std::size_t getRandomIndex(std::size_t const& count) {
+		return std::uniform_int_distribution<std::size_t>(0, count - 1)(m_random);
+	}
+
+	std::mt19937_64 m_random;
+	std::array<std::string, NUM_ROWS> m_fieldString;
+	std::vector<std::pair<std::size_t, std::size_t>> m_holeConnections;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#endif
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/array.hpp>
+#include <cereal/types/bitset.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/queue.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/archives/binary.hpp>
+
+#include "AntichainSet.h"
+#include "Boards.h"
+#include "DenseVisitedSet.h"
+#include "LegacyTrie.h"
+#include "Play.h"
+#include "SearchOptions.h"
+#include "StrideTrie.h"
+#include "Trie.h"
+#include "ZddSet.h"
+
+/*
+	Compares the visited sets on the operations of a real --christmas run.
+	'record' runs play() with a RecordingVisitedSet and writes the first operations to a file, 'replay' runs them against every structure.
+	The memory of a structure is how much the resident memory of the process grew while replaying into it, measured with all its sets still alive.
+	Evicting supersets on insert never changes the result of a query, so all replays give the same hits.
+	Every operation is two uint32_t: the index of the visited set, with RECORDED_INSERT set for inserts, and the present state.
+*/
+
+static constexpr std::size_t CHRISTMAS_PRESENT_COUNT = 24;
+static constexpr std::uint32_t RECORDED_INSERT = 0x80000000u;
+
+class Recording {
+public:
+	Recording() : m_stream(), m_operationCount(0), m_maxOperationCount(0) {
+		//
+	}
+
+	void open(std::string const& filename, std::size_t const& maxOperationCount) {
+		m_stream.open(filename, std::ios::binary);
+		if (!m_stream) {
+			std::cerr << "Failed to open '" << filename << "' for writing!" << std::endl;
+			exit(-1);
+		}
+		m_maxOperationCount = maxOperationCount;
+	}
+
+	void append(std::uint32_t const& setIndex, std::bitset<CHRISTMAS_PRESENT_COUNT> const& value) {
+		std::uint32_t const operation[2] = { setIndex, static_cast<std::uint32_t>(value.to_ulong()) };
+		m_stream.write(reinterpret_cast<char const*>(operation), sizeof(operation));
+		if (++m_operationCount == m_maxOperationCount) {
+			m_stream.close();
+			std::cout << "Recorded " << m_operationCount << " operations." << std::endl;
+			exit(0);
+		}
+	}
+private:
+	std::ofstream m_stream;
+	std::size_t m_operationCount;
+	std::size_t m_maxOperationCount;
+};
+
+static Recording recording;
+
+/*
+	An AntichainSet that appends every operation to the recording. play() creates one per stop cell in order, so the indices are the stop cells.
+*/
+class RecordingVisitedSet {
+public:
+	RecordingVisitedSet() : m_index(nextIndex++), m_set() {
+		//
+	}
+	~RecordingVisitedSet() {
+		//
+	}
+
+	static std::string getName() {
+		return "recording";
+	}
+
+	bool hasValueOrSubsetThereof(std::bitset<CHRISTMAS_PRESENT_COUNT> const& value) const {
+		recording.append(m_index, value);
+		return m_set.hasValueOrSubsetThereof(value);
+	}
+
+	void insertValue(std::bitset<CHRISTMAS_PRESENT_COUNT> const& value) {
+		recording.append(m_index | RECORDED_INSERT, value);
+		m_set.insertValue(value);
+	}
+
+	void insertValueEvictingSupersets(std::bitset<CHRISTMAS_PRESENT_COUNT> const& value) {
+		recording.append(m_index | RECORDED_INSERT, value);
+		m_set.insertValueEvictingSupersets(value);
+	}
+
+	template<class Archive>
+	void serialize(Archive& archive) {
+		archive(m_index, m_set);
+	}
+private:
+	static inline std::uint32_t nextIndex = 0;
+
+	std::uint32_t m_index;
+	AntichainSet<CHRISTMAS_PRESENT_COUNT> m_set;
+};
+
+// The memory of this process backed by physical memory, 0 if unknown. Freed memory is handed back to the OS first where possible, so it does not count.
+std::size_t getResidentBytes() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return 0;
+	}
+	return counters.WorkingSetSize;
+#else
+#ifdef __GLIBC__
+	malloc_trim(0);
+#endif
+	std::ifstream statm("/proc/self/statm");
+	std::size_t totalPages = 0;
+	std::size_t residentPages = 0;
+	if (!(statm >> totalPages >> residentPages)) {
+		return 0;
+	}
+	return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Inserts with insertValueEvictingSupersets() like play() if EVICT_SUPERSETS is set, with insertValue() like play() before that otherwise.
+template<typename VISITED_SET, bool EVICT_SUPERSETS>
+void replay(std::string const& name, std::vector<std::uint32_t> const& operations) {
+	std::uint32_t setCount = 0;
+	for (std::size_t i = 0; i < operations.size(); i += 2) {
+		setCount = std::max(setCount, (operations[i] & ~RECORDED_INSERT) + 1);
+	}
+	std::size_t const residentBefore = getResidentBytes();
+	std::vector<VISITED_SET> sets(setCount);
+
+	std::size_t queryCount = 0;
+	std::size_t hitCount = 0;
+	auto const begin = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < operations.size(); i += 2) {
+		std::bitset<CHRISTMAS_PRESENT_COUNT> const value(operations[i + 1]);
+		if ((operations[i] & RECORDED_INSERT) != 0) {
+			if constexpr(EVICT_SUPERSETS) {
+				sets[operations[i] & ~RECORDED_INSERT].insertValueEvictingSupersets(value);
+			} else {
+				sets[operations[i] & ~RECORDED_INSERT].insertValue(value);
+			}
+		} else {
+			++queryCount;
+			if (sets[operations[i]].hasValueOrSubsetThereof(value)) {
+				++hitCount;
+			}
+		}
+	}
+	auto const end = std::chrono::steady_clock::now();
+	std::size_t const residentAfter = getResidentBytes();
+	std::cout << name << ": " << queryCount << " queries with " << hitCount << " hits and " << (operations.size() / 2 - queryCount) << " inserts in " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " ms, ";
+	if ((residentBefore == 0) || (residentAfter == 0)) {
+		std::cout << "unknown memory." << std::endl;
+	} else {
+		std::cout << ((residentAfter > residentBefore) ? (residentAfter - residentBefore) / (1024 * 1024) : 0) << " MiB." << std::endl;
+	}
+}
+
+void printHelp() {
+	std::cerr << "Usage:" << std::endl;
+	std::cerr << "VisitedSetBenchmark record [FILENAME] [N]: Runs --christmas and records its first N visited set operations, default is 10000000." << std::endl;
+	std::cerr << "VisitedSetBenchmark replay [FILENAME]: Replays the recorded operations against LegacyTrie, Trie, StrideTrie with two and four bits per level, ZddSet, DenseVisitedSet and AntichainSet, with the time and the memory each took." << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		printHelp();
+		return -1;
+	}
+	std::string const mode = argv[1];
+	std::string const filename = argv[2];
+
+	if (mode.compare("record") == 0) {
+		std::size_t const maxOperationCount = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 10000000;
+		if (maxOperationCount == 0) {
+			std::cerr << "The number of operations has to be positive, got '" << argv[3] << "'!" << std::endl;
+			return -1;
+		}
+		recording.open(filename, maxOperationCount);
+		SearchOptions options;
+		options.noBackups = true;
+		play<40, 40, true, CHRISTMAS_PRESENT_COUNT, RecordingVisitedSet>(fieldStringChristmas, holeConnectionsChristmas, options);
+		std::cout << "The search ended before recording " << maxOperationCount << " operations." << std::endl;
+		return 0;
+	} else if (mode.compare("replay") == 0) {
+		std::ifstream is(filename, std::ios::binary | std::ios::ate);
+		if (!is) {
+			std::cerr << "Failed to open '" << filename << "'!" << std::endl;
+			return -1;
+		}
+		std::vector<std::uint32_t> operations(static_cast<std::size_t>(is.tellg()) / (2 * sizeof(std::uint32_t)) * 2);
+		is.seekg(0);
+		is.read(reinterpret_cast<char*>(operations.data()), operations.size() * sizeof(std::uint32_t));
+		std::cout << "Loaded " << (operations.size() / 2) << " operations from '" << filename << "'." << std::endl;
+
+		replay<LegacyTrie<CHRISTMAS_PRESENT_COUNT>, false>("LegacyTrie, plain inserts", operations);
+		replay<Trie<CHRISTMAS_PRESENT_COUNT>, false>("Trie, plain inserts", operations);
+		replay<StrideTrie<CHRISTMAS_PRESENT_COUNT, 2>, false>("StrideTrie<2>, plain inserts", operations);
+		replay<StrideTrie<CHRISTMAS_PRESENT_COUNT, 4>, false>("StrideTrie<4>, plain inserts", operations);
+		replay<Trie<CHRISTMAS_PRESENT_COUNT>, true>("Trie", operations);
+		replay<StrideTrie<CHRISTMAS_PRESENT_COUNT, 2>, true>("StrideTrie<2>", operations);
+		replay<StrideTrie<CHRISTMAS_PRESENT_COUNT, 4>, true>("StrideTrie<4>", operations);
+		replay<ZddSet<CHRISTMAS_PRESENT_COUNT>, true>("ZddSet", operations);
+		replay<DenseVisitedSet<CHRISTMAS_PRESENT_COUNT>, true>("DenseVisitedSet", operations);
+		replay<AntichainSet<CHRISTMAS_PRESENT_COUNT>, true>("AntichainSet", operations);
+		return 0;
+	}
+	printHelp();
+	return -1;
+}
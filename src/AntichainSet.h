@@ -0,0 +1,118 @@
+#ifndef ANTICHAINSET_H_
+#define ANTICHAINSET_H_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SubsetScan.h"
+
+/*
+	Same interface as Trie, but stores the values as flat, sorted uint32_t arrays, one per popcount.
+	A stored value can only be a subset of the query if its popcount is not larger, so a query only scans the buckets up to the popcount of the query, using the kernel from SubsetScan.h.
+*/
+template <std::size_t BIT_COUNT>
+class AntichainSet {
+public:
+	static_assert(BIT_COUNT <= 32, "AntichainSet supports at most 32 bits.");
+
+	// The name of --visited, also written to state backups, see play()
+	static std::string getName() {
+		return "antichain";
+	}
+
+	AntichainSet() : m_buckets() {
+		//
+	}
+	~AntichainSet() {
+		//
+	}
+
+	bool hasValueOrSubsetThereof(std::bitset<BIT_COUNT> const& value) const {
+		std::uint32_t const bits = static_cast<std::uint32_t>(value.to_ulong());
+		std::uint32_t const forbiddenBits = ~bits;
+		std::size_t const maxPopcount = value.count();
+		for (std::size_t popcount = 0; popcount <= maxPopcount; ++popcount) {
+			if (containsSubset(m_buckets[popcount], forbiddenBits)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Whether exactly this value is stored.
+	bool hasValue(std::bitset<BIT_COUNT> const& value) const {
+		std::vector<std::uint32_t> const& bucket = m_buckets[value.count()];
+		return std::binary_search(bucket.cbegin(), bucket.cend(), static_cast<std::uint32_t>(value.to_ulong()));
+	}
+
+	void insertValue(std::bitset<BIT_COUNT> const& value) {
+		std::uint32_t const bits = static_cast<std::uint32_t>(value.to_ulong());
+		std::vector<std::uint32_t>& bucket = m_buckets[value.count()];
+		auto const it = std::lower_bound(bucket.begin(), bucket.end(), bits);
+		if ((it == bucket.end()) || (*it != bits)) {
+			bucket.insert(it, bits);
+		}
+	}
+
+	/*
+		Inserts the value and removes all stored supersets of it, see Trie.
+		Supersets can only live in the buckets with a larger popcount, or be equal to the value.
+	*/
+	void insertValueEvictingSupersets(std::bitset<BIT_COUNT> const& value) {
+		evictSupersets(static_cast<std::uint32_t>(value.to_ulong()), value.count() + 1);
+		insertValue(value);
+	}
+
+	// Removes all stored supersets of the value, including the value itself.
+	void evictSupersets(std::bitset<BIT_COUNT> const& value) {
+		evictSupersets(static_cast<std::uint32_t>(value.to_ulong()), value.count());
+	}
+
+	std::size_t size() const {
+		std::size_t result = 0;
+		for (auto it = m_buckets.cbegin(); it != m_buckets.cend(); ++it) {
+			result += it->size();
+		}
+		return result;
+	}
+
+	// Calls f with the bits of every stored value, by increasing popcount.
+	template<typename F>
+	void forEachValue(F const& f) const {
+		for (auto itO = m_buckets.cbegin(); itO != m_buckets.cend(); ++itO) {
+			for (auto it = itO->cbegin(); it != itO->cend(); ++it) {
+				f(*it);
+			}
+		}
+	}
+
+	template<class Archive>
+	void serialize(Archive& archive) {
+		archive(m_buckets);
+	}
+private:
+	void evictSupersets(std::uint32_t const& bits, std::size_t const& minPopcount) {
+		for (std::size_t popcount = minPopcount; popcount <= BIT_COUNT; ++popcount) {
+			std::vector<std::uint32_t>& bucket = m_buckets[popcount];
+			bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [bits](std::uint32_t const& stored) { return (bits & ~stored) == 0; }), bucket.end());
+		}
+	}
+
+	// Small buckets are not worth the indirect call into the vectorized kernel.
+	static inline bool containsSubset(std::vector<std::uint32_t> const& bucket, std::uint32_t const& forbiddenBits) {
+		if (bucket.size() < SUBSET_SCAN_MIN_SIZE) {
+			return containsSubsetScalar(bucket.data(), bucket.size(), forbiddenBits);
+		}
+		return subsetScan(bucket.data(), bucket.size(), forbiddenBits);
+	}
+
+	static constexpr std::size_t SUBSET_SCAN_MIN_SIZE = 16;
+
+	std::array<std::vector<std::uint32_t>, BIT_COUNT + 1> m_buckets;
+};
+
+#endif
@@ -2,7 +2,9 @@
 #define BOARD_H_
 
 #include <array>
+#include <bitset>
 #include <cstdint>
+#include <limits>
 #include <optional>
 #include <vector>
 
@@ -13,12 +15,101 @@ enum class Direction {
 	UP, DOWN, LEFT, RIGHT
 };
 
+constexpr std::size_t DIRECTION_COUNT = 4;
+
+inline char directionToChar(Direction const& dir) {
+	switch (dir) {
+		case Direction::UP:
+			return 'U';
+		case Direction::DOWN:
+			return 'D';
+		case Direction::LEFT:
+			return 'L';
+		case Direction::RIGHT:
+			return 'R';
+	}
+	return '?';
+}
+
+constexpr Direction getOppositeDirection(Direction const& dir) {
+	switch (dir) {
+		case Direction::UP:
+			return Direction::DOWN;
+		case Direction::DOWN:
+			return Direction::UP;
+		case Direction::LEFT:
+			return Direction::RIGHT;
+		case Direction::RIGHT:
+			return Direction::LEFT;
+	}
+	return dir;
+}
+
+template<std::size_t PRESENT_COUNT>
+struct SlideTransition {
+public:
+	static constexpr std::size_t INVALID_POSITION = std::numeric_limits<std::size_t>::max();
+
+	SlideTransition() : target(INVALID_POSITION), keepMask() {
+		//
+	}
+
+	inline bool isValid() const noexcept(true) {
+		return target != INVALID_POSITION;
+	}
+
+	// Where the penguin comes to rest, after holes have been applied.
+	std::size_t target;
+	// AND this with a present state to remove all presents collected on the way.
+	std::bitset<PRESENT_COUNT> keepMask;
+};
+
+/*
+	An edge of the stop cell graph, see Board.
+*/
+template<std::size_t PRESENT_COUNT>
+struct StopCellEdge {
+public:
+	StopCellEdge(std::uint32_t const& target, Direction const& direction, std::bitset<PRESENT_COUNT> const& keepMask) : target(target), direction(direction), keepMask(keepMask) {
+		//
+	}
+
+	// Index of the stop cell the penguin comes to rest on.
+	std::uint32_t target;
+	Direction direction;
+	// AND this with a present state to remove all presents collected on the way.
+	std::bitset<PRESENT_COUNT> keepMask;
+};
+
+/*
+	An edge of the stop cell graph seen from its end, see Board.
+*/
+template<std::size_t PRESENT_COUNT>
+struct StopCellPredecessor {
+public:
+	StopCellPredecessor(std::uint32_t const& origin, Direction const& direction, std::bitset<PRESENT_COUNT> const& keepMask) : origin(origin), direction(direction), keepMask(keepMask) {
+		//
+	}
+
+	// Index of the stop cell the slide starts from.
+	std::uint32_t origin;
+	Direction direction;
+	// AND this with a present state to remove all presents collected on the way.
+	std::bitset<PRESENT_COUNT> keepMask;
+};
+
 template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
 class Board {
 public:
-	Board(std::array<BoardPiece, (NUM_ROWS * NUM_COLS)> const& pieces, std::size_t const& penguinStartingPosition, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections)
-		: m_pieces(pieces), m_startingPosition(penguinStartingPosition), m_holeConnections(translateHoleConnectionPairsToLookup(holeConnections)) {
-		//
+	/*
+		Without the slide graph, neither the transitions nor the stop cell graph are built and only the grid level slides below can be used.
+	*/
+	Board(std::vector<BoardPiece> const& pieces, std::size_t const& penguinStartingPosition, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, PresentBase<NUM_ROWS, NUM_COLS> const& presentBase, bool const& withSlideGraph)
+		: m_pieces(pieces), m_startingPosition(penguinStartingPosition), m_holeConnectionPairs(holeConnections), m_holeConnections(translateHoleConnectionPairsToLookup(holeConnections)), m_transitions(withSlideGraph ? buildTransitions(presentBase) : std::vector<SlideTransition<PRESENT_COUNT>>()), m_stopCellPositions(), m_stopCellIsTarget(), m_stopCellEdgeOffsets(), m_stopCellEdges(), m_stopCellPredecessorOffsets(), m_stopCellPredecessors() {
+		if (withSlideGraph) {
+			buildStopCellGraph();
+			buildStopCellPredecessors();
+		}
 	}
 	~Board() {
 		//
@@ -36,8 +127,8 @@ public:
 		return result;
 	}
 
-	static std::pair<Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT>> fromFieldString(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections) {
-		std::array<BoardPiece, NUM_ROWS* NUM_COLS> pieces;
+	static std::pair<Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT>> fromFieldString(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, bool const& withSlideGraph = true) {
+		std::vector<BoardPiece> pieces(NUM_ROWS * NUM_COLS);
 		std::size_t linearCount = 0;
 		BoardPiece piece;
 		std::optional<std::size_t> penguinPosition;
@@ -104,7 +195,8 @@ public:
 			exit(-1);
 		}
 
-		return std::make_pair(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(pieces, penguinPosition.value(), holeConnections), PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT>(presentPositions));
+		PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const presentOverlay(presentPositions);
+		return std::make_pair(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(pieces, penguinPosition.value(), holeConnections, presentOverlay.getBase(), withSlideGraph), presentOverlay);
 	}
 
 	std::size_t getPenguinStartingPosition() const {
@@ -171,8 +263,8 @@ public:
 	}
 
 	template <Direction dir>
-	inline std::size_t moveInDir(std::size_t pos, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT>& presents) const {
-		static std::size_t result = 0;
+	inline std::size_t moveInDir(std::size_t pos, PresentOverlayView<NUM_ROWS, NUM_COLS, PRESENT_COUNT>& presents) const {
+		std::size_t result = 0;
 		while (canMoveInDir<dir>(pos, result)) {
 			pos = result;
 			presents.collectOn(pos);
@@ -182,7 +274,235 @@ public:
 		}
 		return swapHoleIfOn(pos);
 	}
+
+	/*
+		Grid level slides, walking the cells on every call instead of looking them up, so they also work on boards built without the slide graph.
+		getSlideTarget() is where a slide comes to rest, with hole swaps applied, or SlideTransition::INVALID_POSITION if the penguin can not move at all.
+	*/
+	template <Direction dir>
+	inline std::size_t getSlideTarget(std::size_t const& pos, PresentOverlayView<NUM_ROWS, NUM_COLS, PRESENT_COUNT>& presents) const {
+		std::size_t target;
+		if (!canMoveInDir<dir>(pos, target)) {
+			return SlideTransition<PRESENT_COUNT>::INVALID_POSITION;
+		}
+		return moveInDir<dir>(pos, presents);
+	}
+
+	/*
+		Whether the penguin can come to rest on a cell at all, judged by the cell and its neighbours alone: the starting position, where a hole leads to,
+		a target, or an empty cell with something solid on one side that a slide from the other side runs into. A superset of the stop cells.
+	*/
+	bool canComeToRestOn(std::size_t const& pos) const {
+		if (pos == m_startingPosition) {
+			return true;
+		}
+		for (auto it = m_holeConnectionPairs.cbegin(); it != m_holeConnectionPairs.cend(); ++it) {
+			if (it->second == pos) {
+				return true;
+			}
+		}
+		BoardPiece const& piece = getPieceAt(pos);
+		if (piece == BoardPiece::TARGET) {
+			return true;
+		} else if (piece != BoardPiece::EMPTY) {
+			return false;
+		}
+		return isSlideEndInDir<Direction::UP>(pos) || isSlideEndInDir<Direction::DOWN>(pos) || isSlideEndInDir<Direction::LEFT>(pos) || isSlideEndInDir<Direction::RIGHT>(pos);
+	}
+
+	/*
+		The grid level counterpart of the stop cell predecessors: calls callback(origin, direction) for every cell the penguin can rest on, see canComeToRestOn(),
+		from which a slide in the given direction comes to rest on pos, with hole swaps applied. Slides from targets are left out, as the game ends there.
+	*/
+	template <typename CALLBACK>
+	void forEachSlideInto(std::size_t const& pos, CALLBACK const& callback) const {
+		// The slide either stops on pos itself or on a hole leading there
+		if (swapHoleIfOn(pos) == pos) {
+			forEachSlideEndingOn(pos, callback);
+		}
+		for (auto it = m_holeConnectionPairs.cbegin(); it != m_holeConnectionPairs.cend(); ++it) {
+			if ((it->second == pos) && (it->first != pos)) {
+				forEachSlideEndingOn(it->first, callback);
+			}
+		}
+	}
+
+	template <Direction dir>
+	inline SlideTransition<PRESENT_COUNT> const& getTransition(std::size_t const& pos) const {
+		return m_transitions[pos * DIRECTION_COUNT + static_cast<std::size_t>(dir)];
+	}
+
+	/*
+		The stop cell graph only contains the cells the penguin can come to rest on, reachable from its starting position, numbered in BFS order starting with 0 for the starting position.
+		Edges are stored in CSR form, the edges of a stop cell are ordered by direction (up, down, left, right) and targets have no outgoing edges, as the game ends there.
+	*/
+	std::size_t getStopCellCount() const {
+		return m_stopCellPositions.size();
+	}
+
+	std::size_t getStartingStopCell() const {
+		return 0;
+	}
+
+	std::size_t getStopCellPosition(std::size_t const& stopCell) const {
+		return m_stopCellPositions[stopCell];
+	}
+
+	inline bool isTargetStopCell(std::size_t const& stopCell) const {
+		return m_stopCellIsTarget[stopCell];
+	}
+
+	// FNV-1a over the stop cell graph, for caching everything computed from it alone on disk.
+	std::uint64_t getFingerprint() const {
+		std::uint64_t result = 0xcbf29ce484222325ull;
+		auto const add = [&result](std::uint64_t const& value) {
+			for (std::size_t i = 0; i < 8; ++i) {
+				result ^= (value >> (i * 8)) & 0xFF;
+				result *= 0x100000001b3ull;
+			}
+		};
+		add(PRESENT_COUNT);
+		add(getStopCellCount());
+		for (std::size_t stopCell = 0; stopCell < getStopCellCount(); ++stopCell) {
+			add(isTargetStopCell(stopCell) ? 1 : 0);
+			for (auto it = getStopCellEdgesBegin(stopCell); it != getStopCellEdgesEnd(stopCell); ++it) {
+				add(it->target);
+				add(static_cast<std::uint64_t>(it->direction));
+				add(it->keepMask.to_ullong());
+			}
+		}
+		return result;
+	}
+
+	inline StopCellEdge<PRESENT_COUNT> const* getStopCellEdgesBegin(std::size_t const& stopCell) const {
+		return m_stopCellEdges.data() + m_stopCellEdgeOffsets[stopCell];
+	}
+
+	inline StopCellEdge<PRESENT_COUNT> const* getStopCellEdgesEnd(std::size_t const& stopCell) const {
+		return m_stopCellEdges.data() + m_stopCellEdgeOffsets[stopCell + 1];
+	}
+
+	/*
+		All slides ending in the given stop cell, with hole swaps already applied, in the same CSR layout as the edges.
+		Like the edges, this only covers slides starting on stop cells reachable from the starting position, and not from targets.
+		They are ordered by origin, and by direction for the same origin.
+	*/
+	inline StopCellPredecessor<PRESENT_COUNT> const* getStopCellPredecessorsBegin(std::size_t const& stopCell) const {
+		return m_stopCellPredecessors.data() + m_stopCellPredecessorOffsets[stopCell];
+	}
+
+	inline StopCellPredecessor<PRESENT_COUNT> const* getStopCellPredecessorsEnd(std::size_t const& stopCell) const {
+		return m_stopCellPredecessors.data() + m_stopCellPredecessorOffsets[stopCell + 1];
+	}
 private:
+	// Whether a slide in the given direction can reach the empty cell pos and stops there.
+	template <Direction dir>
+	inline bool isSlideEndInDir(std::size_t const& pos) const {
+		std::size_t target;
+		return !canMoveInDir<dir>(pos, target) && canMoveInDir<getOppositeDirection(dir)>(pos, target);
+	}
+
+	template <typename CALLBACK>
+	void forEachSlideEndingOn(std::size_t const& end, CALLBACK const& callback) const {
+		forEachSlideEndingOnInDir<Direction::UP>(end, callback);
+		forEachSlideEndingOnInDir<Direction::DOWN>(end, callback);
+		forEachSlideEndingOnInDir<Direction::LEFT>(end, callback);
+		forEachSlideEndingOnInDir<Direction::RIGHT>(end, callback);
+	}
+
+	template <Direction dir, typename CALLBACK>
+	void forEachSlideEndingOnInDir(std::size_t const& end, CALLBACK const& callback) const {
+		std::size_t target;
+		if ((getPieceAt(end) == BoardPiece::EMPTY) && canMoveInDir<dir>(end, target)) {
+			return;
+		}
+		// Walk backwards: every cell up to the first non-empty one starts a slide ending here
+		std::size_t pos = end;
+		std::size_t origin = 0;
+		while (canMoveInDir<getOppositeDirection(dir)>(pos, origin) && (origin != end)) {
+			if ((getPieceAt(origin) != BoardPiece::TARGET) && canComeToRestOn(origin)) {
+				callback(origin, dir);
+			}
+			if (getPieceAt(origin) != BoardPiece::EMPTY) {
+				break;
+			}
+			pos = origin;
+		}
+	}
+
+	void buildStopCellGraph() {
+		std::size_t const noStopCell = std::numeric_limits<std::size_t>::max();
+		std::vector<std::size_t> positionToStopCell(NUM_ROWS * NUM_COLS, noStopCell);
+		positionToStopCell[m_startingPosition] = 0;
+		m_stopCellPositions.push_back(m_startingPosition);
+		m_stopCellEdgeOffsets.push_back(0);
+		for (std::size_t stopCell = 0; stopCell < m_stopCellPositions.size(); ++stopCell) {
+			std::size_t const pos = m_stopCellPositions[stopCell];
+			bool const isTarget = getPieceAt(pos) == BoardPiece::TARGET;
+			m_stopCellIsTarget.push_back(isTarget);
+			if (!isTarget) {
+				for (std::size_t d = 0; d < DIRECTION_COUNT; ++d) {
+					SlideTransition<PRESENT_COUNT> const& transition = m_transitions[pos * DIRECTION_COUNT + d];
+					if (!transition.isValid()) {
+						continue;
+					}
+					if (positionToStopCell[transition.target] == noStopCell) {
+						positionToStopCell[transition.target] = m_stopCellPositions.size();
+						m_stopCellPositions.push_back(transition.target);
+					}
+					m_stopCellEdges.push_back(StopCellEdge<PRESENT_COUNT>(static_cast<std::uint32_t>(positionToStopCell[transition.target]), static_cast<Direction>(d), transition.keepMask));
+				}
+			}
+			m_stopCellEdgeOffsets.push_back(m_stopCellEdges.size());
+		}
+	}
+
+	void buildStopCellPredecessors() {
+		std::size_t const stopCellCount = getStopCellCount();
+		m_stopCellPredecessorOffsets.assign(stopCellCount + 1, 0);
+		for (auto it = m_stopCellEdges.cbegin(); it != m_stopCellEdges.cend(); ++it) {
+			++m_stopCellPredecessorOffsets[it->target + 1];
+		}
+		for (std::size_t i = 0; i < stopCellCount; ++i) {
+			m_stopCellPredecessorOffsets[i + 1] += m_stopCellPredecessorOffsets[i];
+		}
+
+		std::vector<std::size_t> nextSlot(m_stopCellPredecessorOffsets.cbegin(), m_stopCellPredecessorOffsets.cend() - 1);
+		m_stopCellPredecessors.assign(m_stopCellEdges.size(), StopCellPredecessor<PRESENT_COUNT>(0, Direction::UP, std::bitset<PRESENT_COUNT>()));
+		for (std::size_t origin = 0; origin < stopCellCount; ++origin) {
+			for (auto it = getStopCellEdgesBegin(origin); it != getStopCellEdgesEnd(origin); ++it) {
+				m_stopCellPredecessors[nextSlot[it->target]++] = StopCellPredecessor<PRESENT_COUNT>(static_cast<std::uint32_t>(origin), it->direction, it->keepMask);
+			}
+		}
+	}
+
+	std::vector<SlideTransition<PRESENT_COUNT>> buildTransitions(PresentBase<NUM_ROWS, NUM_COLS> const& presentBase) const {
+		std::vector<SlideTransition<PRESENT_COUNT>> result;
+		result.resize(NUM_ROWS * NUM_COLS * DIRECTION_COUNT);
+		for (std::size_t pos = 0; pos < NUM_ROWS * NUM_COLS; ++pos) {
+			if (!isPieceNotSolid(getPieceAt(pos))) {
+				continue;
+			}
+			buildTransition<Direction::UP>(pos, presentBase, result);
+			buildTransition<Direction::DOWN>(pos, presentBase, result);
+			buildTransition<Direction::LEFT>(pos, presentBase, result);
+			buildTransition<Direction::RIGHT>(pos, presentBase, result);
+		}
+		return result;
+	}
+
+	template <Direction dir>
+	void buildTransition(std::size_t const& pos, PresentBase<NUM_ROWS, NUM_COLS> const& presentBase, std::vector<SlideTransition<PRESENT_COUNT>>& transitions) const {
+		std::size_t target;
+		if (!canMoveInDir<dir>(pos, target)) {
+			return;
+		}
+		PresentOverlayView<NUM_ROWS, NUM_COLS, PRESENT_COUNT> overlay(presentBase, std::bitset<PRESENT_COUNT>().set());
+		SlideTransition<PRESENT_COUNT>& transition = transitions[pos * DIRECTION_COUNT + static_cast<std::size_t>(dir)];
+		transition.target = moveInDir<dir>(pos, overlay);
+		transition.keepMask = overlay.getRepresentation();
+	}
+
 	inline std::size_t swapHoleIfOn(std::size_t const& pos) const {
 #ifdef _DEBUG
 		if (pos >= m_holeConnections.size()) {
@@ -209,9 +529,19 @@ private:
 		return row * NUM_COLS + col;
 	}
 
-	std::array<BoardPiece, NUM_ROWS* NUM_COLS> const m_pieces;
+	// Like all per cell tables on the heap, large boards would not fit on the stack.
+	std::vector<BoardPiece> const m_pieces;
 	std::size_t const m_startingPosition;
+	std::vector<std::pair<std::size_t, std::size_t>> const m_holeConnectionPairs;
 	std::vector<std::size_t> const m_holeConnections;
+	std::vector<SlideTransition<PRESENT_COUNT>> const m_transitions;
+
+	std::vector<std::size_t> m_stopCellPositions;
+	std::vector<bool> m_stopCellIsTarget;
+	std::vector<std::size_t> m_stopCellEdgeOffsets;
+	std::vector<StopCellEdge<PRESENT_COUNT>> m_stopCellEdges;
+	std::vector<std::size_t> m_stopCellPredecessorOffsets;
+	std::vector<StopCellPredecessor<PRESENT_COUNT>> m_stopCellPredecessors;
 };
 
 #endif
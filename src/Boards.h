@@ -0,0 +1,86 @@
+#ifndef BOARDS_H_
+#define BOARDS_H_
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The boards of the two puzzles, shared by the main program and the benchmarks.
+static const std::array<std::string, 20> fieldStringBasic = {
+	"####################", 
+	"#   # # #          #", 
+	"#      ###  #     O#", 
+	"#       #   #  #   #", 
+	"##  # #  # #       #", 
+	"#       #    #   ###", 
+	"#      # #  #      #", 
+	"##      #       ## #", 
+	"#    ### ### ## #  #", 
+	"#    #P #          #", 
+	"# O               ##", 
+	"#       #          #", 
+	"#        # #       #", 
+	"#   #   #   #    # #", 
+	"#    #   #  #  #   #", 
+	"#  #    #      ## ##", 
+	"#     #  #    ##   #", 
+	"#     # # #        X", 
+	"# #  ##    #    #  #", 
+	"####################"
+};
+static const std::vector<std::pair<std::size_t, std::size_t>> holeConnectionsBasic = {
+	{58, 202},
+	{202, 58}
+};
+
+static const std::array<std::string, 40> fieldStringChristmas = {
+	"TT T#T   #T#T#T#T #   T #T#  #TT  #T$  #",
+	"T     #     $                          T",
+	"T       $  T TT  TT##T#TT   T  T  T  T  ",
+	"   T     T   T  T         T$            ",
+	"#T     T   O   T$TT##TTTT   TT T        ",
+	"  $ T                           T   T   ",
+	"#                TT#TTTTT$             T",
+	"     T  T    TT$                  T$    ",
+	" T          T$   T#TT#T#T  T#          #",
+	"        T    T T         #      T      O",
+	"# T     #    T   T##TTTT# T T      T#T $",
+	"    T T              P         # $     #",
+	"#          TT    T##T#TTT T   T    T T #",
+	"     TTT   T   T       $     #   T   T T",
+	"T  #$        T  #T###TT#T T TT          ",
+	"   ## T   T     T        T T        T T#",
+	"  #T        #  T#T##TT#T#  T T    T     ",
+	"T T  T T T  #                # TT T    #",
+	"     T   #   T   TT#TTTTT T# T       T  ",
+	"T  T       #  #     $           T   TTT ",
+	"   T  T      T  #T##TTT## T  T#     T   ",
+	"#   T    T    T T        TTT  T TT     T",
+	"$T  #T    T    T TT#TT### T  T        T ",
+	"# T T#    T #T            TT   T T T    ",
+	"#        T  $    T###T#TT            T  ",
+	"   T T        T        #  T     T    TT ",
+	"T T T  ##   T T  T  T  T$T    T  T T  $ ",
+	"   TT  T      T T $# T T   TT        T T",
+	"      #TT  T                T    #     T",
+	"  T        TTT T T T  T#T           T  T",
+	"T  T    T      T             T T      TT",
+	"#T   T        T  T TT # TT  TT  #      #",
+	"#   T    ##    $   TT    #  #  T# T     ",
+	" T     T     T TT TT#T      T   T       ",
+	" # T              T T   T  #T T #  TT T#",
+	"T  T      T T #    T  T   $            T",
+	"T      TT       #        # #  T       TT",
+	"# T         T      T          # T  T   #",
+	"T$ O           T     T     T    T      X",
+	" T #   # T    #T# #  ##   T  T  $ # #TTT"
+};
+
+static const std::vector<std::pair<std::size_t, std::size_t>> holeConnectionsChristmas = {
+	{399, 1523},
+	{1523, 171},
+	{171, 399}
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef BUCKETHASHING_H_
+#define BUCKETHASHING_H_
+
+#include <cstdint>
+
+/*
+	Shared by the fixed-size hash tables, see TranspositionTable and ConcurrentDepthTable.
+*/
+
+// The largest power of two number of buckets of bucketByteCount bytes each that fits into byteCount, but at least one.
+inline std::size_t getBucketCount(std::uint64_t const& byteCount, std::size_t const& bucketByteCount) {
+	std::size_t result = 1;
+	while ((result * 2 * bucketByteCount) <= byteCount) {
+		result *= 2;
+	}
+	return result;
+}
+
+// The bucket of a key among a power of two number of buckets.
+inline std::size_t getBucketIndex(std::uint64_t key, std::size_t const& bucketCount) {
+	// The finalizer of splitmix64, as neighbouring states only differ in a few bits
+	key ^= key >> 30;
+	key *= 0xbf58476d1ce4e5b9ull;
+	key ^= key >> 27;
+	key *= 0x94d049bb133111ebull;
+	key ^= key >> 31;
+	return static_cast<std::size_t>(key & (bucketCount - 1));
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef BUCKETQUEUE_H_
+#define BUCKETQUEUE_H_
+
+#include <cstdint>
+#include <vector>
+
+/*
+	A priority queue for small integer priorities, with one bucket per priority.
+	Popping returns an element of the lowest priority, the one pushed last among those, so ties are resolved depth-first.
+	As long as priorities never drop below the lowest one in the queue, as for A* with a consistent heuristic, both push and pop are O(1) amortized.
+*/
+template <typename T>
+class BucketQueue {
+public:
+	BucketQueue() : m_buckets(), m_lowestPriority(0), m_size(0) {
+		//
+	}
+	~BucketQueue() {
+		//
+	}
+
+	inline void push(std::size_t const& priority, T const& value) {
+		if (m_buckets.size() <= priority) {
+			m_buckets.resize(priority + 1);
+		}
+		m_buckets[priority].push_back(value);
+		if ((m_size == 0) || (priority < m_lowestPriority)) {
+			m_lowestPriority = priority;
+		}
+		++m_size;
+	}
+
+	// The queue must not be empty.
+	inline T pop() {
+		while (m_buckets[m_lowestPriority].empty()) {
+			++m_lowestPriority;
+		}
+		T const result = m_buckets[m_lowestPriority].back();
+		m_buckets[m_lowestPriority].pop_back();
+		--m_size;
+		return result;
+	}
+
+	// The queue must not be empty.
+	inline std::size_t getLowestPriority() {
+		while (m_buckets[m_lowestPriority].empty()) {
+			++m_lowestPriority;
+		}
+		return m_lowestPriority;
+	}
+
+	inline bool empty() const noexcept(true) {
+		return m_size == 0;
+	}
+
+	inline std::size_t size() const noexcept(true) {
+		return m_size;
+	}
+
+	template<class Archive>
+	void serialize(Archive& archive) {
+		archive(m_buckets, m_lowestPriority, m_size);
+	}
+private:
+	std::vector<std::vector<T>> m_buckets;
+	std::size_t m_lowestPriority;
+	std::size_t m_size;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef CONCURRENTDEPTHTABLE_H_
+#define CONCURRENTDEPTHTABLE_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "BucketHashing.h"
+#include "MemoryMapping.h"
+
+/*
+	A fixed-size hash table shared by all threads of a depth-first search, remembering the smallest depth every state was entered with.
+	A state entered again with at least that depth can be skipped, as the earlier visit searches it with at least as many moves left.
+	Key and depth are packed into one 64-bit word, so entries are updated with a single atomic operation and are never torn.
+	Entries are grouped into buckets of one cache line, a full bucket replaces its deepest entry, as that covers the smallest subtree.
+	Losing an entry only costs pruning, never correctness.
+*/
+class ConcurrentDepthTable {
+public:
+	static constexpr std::size_t BUCKET_SIZE = 8;
+	static constexpr std::size_t KEY_BITS = 47;
+	static constexpr std::uint32_t MAX_DEPTH = 0xFFFF;
+
+	explicit ConcurrentDepthTable(std::uint64_t const& byteCount) : m_bucketCount(getBucketCount(byteCount, BUCKET_SIZE * sizeof(std::uint64_t))), m_mapping(m_bucketCount * BUCKET_SIZE * sizeof(std::uint64_t)), m_entries(static_cast<std::atomic<std::uint64_t>*>(m_mapping.getData())) {
+		static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t), "Atomic words have to be plain words, as they live in zeroed memory.");
+	}
+	~ConcurrentDepthTable() {
+		//
+	}
+
+	/*
+		Records that the state is entered with the given depth.
+		Returns false if it has already been entered with at most that depth, in which case it should be skipped.
+	*/
+	bool tryEnter(std::uint64_t const& key, std::uint32_t const& depth) {
+		std::uint64_t const storedKey = key + 1;
+		std::uint64_t const entry = (storedKey << 16) | depth;
+		std::atomic<std::uint64_t>* const bucket = m_entries + getBucketIndex(key, m_bucketCount) * BUCKET_SIZE;
+		std::size_t deepest = 0;
+		std::uint32_t deepestDepth = 0;
+		for (std::size_t i = 0; i < BUCKET_SIZE; ++i) {
+			std::uint64_t current = bucket[i].load(std::memory_order_relaxed);
+			while (true) {
+				// A failed exchange reloads current, which might now hold the same state
+				if ((current >> 16) == storedKey) {
+					if ((current & 0xFFFF) <= depth) {
+						return false;
+					}
+					if (bucket[i].compare_exchange_weak(current, entry, std::memory_order_relaxed)) {
+						return true;
+					}
+				} else if (current == 0) {
+					if (bucket[i].compare_exchange_strong(current, entry, std::memory_order_relaxed)) {
+						return true;
+					}
+				} else {
+					break;
+				}
+			}
+			if ((current & 0xFFFF) >= deepestDepth) {
+				deepest = i;
+				deepestDepth = static_cast<std::uint32_t>(current & 0xFFFF);
+			}
+		}
+		// A race here can only overwrite another entry, which is allowed
+		if (deepestDepth > depth) {
+			bucket[deepest].store(entry, std::memory_order_relaxed);
+		}
+		return true;
+	}
+
+	inline std::size_t getCapacity() const {
+		return m_bucketCount * BUCKET_SIZE;
+	}
+private:
+	std::size_t const m_bucketCount;
+	MemoryMapping m_mapping;
+	std::atomic<std::uint64_t>* m_entries;
+};
+
+#endif
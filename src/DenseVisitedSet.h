@@ -0,0 +1,119 @@
+#ifndef DENSEVISITEDSET_H_
+#define DENSEVISITEDSET_H_
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <cereal/cereal.hpp>
+
+#include "MemoryMapping.h"
+
+/*
+	Same interface as Trie, but keeps one bit for every possible value, set if the value or a subset thereof has been inserted.
+	The set bits are therefore always closed under taking supersets, which makes the query a single bit test.
+	Inserting marks all supersets of the value that are not marked yet:
+	Within a 64 bit word, the supersets of the low six bits are spread level by level (shift-or per bit, as in a sum-over-subsets pass),
+	across words, the supersets of the high bits are enumerated depth-first and a word already containing all of them ends the branch,
+	as all of its supersets have been marked by an earlier insert. Every bit is therefore only marked once.
+	The memory is a fixed 2^BIT_COUNT bits, taken from the OS lazily, so untouched regions cost nothing.
+*/
+template <std::size_t BIT_COUNT>
+class DenseVisitedSet {
+public:
+	static constexpr std::size_t MAX_BIT_COUNT = 32;
+	static_assert(BIT_COUNT <= MAX_BIT_COUNT, "DenseVisitedSet supports at most 32 bits.");
+
+	static constexpr std::size_t WORD_BITS = 6;
+	static constexpr std::size_t LOW_BIT_COUNT = (BIT_COUNT < WORD_BITS) ? BIT_COUNT : WORD_BITS;
+	static constexpr std::size_t WORD_COUNT = std::size_t(1) << (BIT_COUNT - LOW_BIT_COUNT);
+	static constexpr std::size_t BYTE_COUNT = WORD_COUNT * sizeof(std::uint64_t);
+
+	static constexpr std::uint64_t getMemoryRequirement(std::size_t const& instanceCount) {
+		return static_cast<std::uint64_t>(instanceCount) * BYTE_COUNT;
+	}
+
+	// The name of --visited, also written to state backups, see play()
+	static std::string getName() {
+		return "dense";
+	}
+
+	DenseVisitedSet() : m_mapping(BYTE_COUNT), m_words(static_cast<std::uint64_t*>(m_mapping.getData())) {
+		//
+	}
+	DenseVisitedSet(DenseVisitedSet const& other) = delete;
+	DenseVisitedSet& operator=(DenseVisitedSet const& other) = delete;
+	DenseVisitedSet(DenseVisitedSet&& other) noexcept : m_mapping(std::move(other.m_mapping)), m_words(other.m_words) {
+		other.m_words = nullptr;
+	}
+	DenseVisitedSet& operator=(DenseVisitedSet&& other) noexcept {
+		m_mapping = std::move(other.m_mapping);
+		m_words = other.m_words;
+		other.m_words = nullptr;
+		return *this;
+	}
+	~DenseVisitedSet() {
+		//
+	}
+
+	bool hasValueOrSubsetThereof(std::bitset<BIT_COUNT> const& value) const {
+		std::uint64_t const bits = value.to_ullong();
+		return ((m_words[bits >> WORD_BITS] >> (bits & LOW_MASK)) & 1u) != 0;
+	}
+
+	void insertValue(std::bitset<BIT_COUNT> const& value) {
+		std::uint64_t const bits = value.to_ullong();
+		markSupersets(bits >> WORD_BITS, getSupersetsInWord(bits & LOW_MASK), 0);
+	}
+
+	/*
+		Stored supersets never have to be removed, as marking all supersets already is the closure of the antichain.
+	*/
+	void insertValueEvictingSupersets(std::bitset<BIT_COUNT> const& value) {
+		insertValue(value);
+	}
+
+	template<class Archive>
+	void save(Archive& archive) const {
+		archive(cereal::binary_data(m_words, BYTE_COUNT));
+	}
+
+	template<class Archive>
+	void load(Archive& archive) {
+		archive(cereal::binary_data(m_words, BYTE_COUNT));
+	}
+private:
+	static constexpr std::uint64_t LOW_MASK = (std::uint64_t(1) << WORD_BITS) - 1;
+	static constexpr std::size_t HIGH_BIT_COUNT = BIT_COUNT - LOW_BIT_COUNT;
+
+	// The bits of a word whose index within the word is a superset of the given low bits.
+	static inline std::uint64_t getSupersetsInWord(std::uint64_t const& lowBits) {
+		std::uint64_t result = std::uint64_t(1) << lowBits;
+		for (std::size_t i = 0; i < LOW_BIT_COUNT; ++i) {
+			if (((lowBits >> i) & 1u) == 0) {
+				result |= result << (std::size_t(1) << i);
+			}
+		}
+		return result;
+	}
+
+	// Marks the given bits in the word and, if anything was new, in all words whose index is a superset, adding high bits from firstBit on.
+	void markSupersets(std::uint64_t const& wordIndex, std::uint64_t const& wordMask, std::size_t const& firstBit) {
+		std::uint64_t& word = m_words[wordIndex];
+		if ((word & wordMask) == wordMask) {
+			return;
+		}
+		word |= wordMask;
+		for (std::size_t i = firstBit; i < HIGH_BIT_COUNT; ++i) {
+			if (((wordIndex >> i) & 1u) == 0) {
+				markSupersets(wordIndex | (std::uint64_t(1) << i), wordMask, i + 1);
+			}
+		}
+	}
+
+	MemoryMapping m_mapping;
+	std::uint64_t* m_words;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef DISTANCEORACLE_H_
+#define DISTANCEORACLE_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+
+/*
+	The number of moves from every stop cell to the nearest target, ignoring presents.
+	Computed once by a backward BFS from all targets over the predecessors in the stop cell graph.
+	As collecting presents can only make a way longer, this is an admissible heuristic for the remaining moves of any state,
+	and it is exact for states that have no presents left to collect.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+class DistanceOracle {
+public:
+	static constexpr std::uint32_t UNREACHABLE = std::numeric_limits<std::uint32_t>::max();
+
+	explicit DistanceOracle(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board) : m_distances(buildDistances(board)) {
+		//
+	}
+	~DistanceOracle() {
+		//
+	}
+
+	inline std::uint32_t getDistance(std::size_t const& stopCell) const {
+		return m_distances[stopCell];
+	}
+
+	/*
+		A shortest way from the stop cell to a target, in O(length of the way).
+		Of all shortest ways, this is the one a forward BFS expanding up, down, left, right would find first.
+	*/
+	std::string getMovesToTarget(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::size_t stopCell) const {
+		std::string result;
+		if (m_distances[stopCell] == UNREACHABLE) {
+			return result;
+		}
+		while (m_distances[stopCell] > 0) {
+			for (auto it = board.getStopCellEdgesBegin(stopCell); it != board.getStopCellEdgesEnd(stopCell); ++it) {
+				if (m_distances[it->target] + 1 == m_distances[stopCell]) {
+					result.push_back(directionToChar(it->direction));
+					stopCell = it->target;
+					break;
+				}
+			}
+		}
+		return result;
+	}
+private:
+	static std::vector<std::uint32_t> buildDistances(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board) {
+		std::size_t const stopCellCount = board.getStopCellCount();
+		std::vector<std::uint32_t> distances(stopCellCount, UNREACHABLE);
+		std::vector<std::uint32_t> queue;
+		queue.reserve(stopCellCount);
+		for (std::size_t stopCell = 0; stopCell < stopCellCount; ++stopCell) {
+			if (board.isTargetStopCell(stopCell)) {
+				distances[stopCell] = 0;
+				queue.push_back(static_cast<std::uint32_t>(stopCell));
+			}
+		}
+		for (std::size_t head = 0; head < queue.size(); ++head) {
+			std::uint32_t const stopCell = queue[head];
+			for (auto it = board.getStopCellPredecessorsBegin(stopCell); it != board.getStopCellPredecessorsEnd(stopCell); ++it) {
+				if (distances[it->origin] == UNREACHABLE) {
+					distances[it->origin] = distances[stopCell] + 1;
+					queue.push_back(it->origin);
+				}
+			}
+		}
+		return distances;
+	}
+
+	std::vector<std::uint32_t> const m_distances;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef ENDGAMEDATABASE_H_
+#define ENDGAMEDATABASE_H_
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Board.h"
+#include "Tablebase.h"
+
+/*
+	The part of the Tablebase for the states with at most maxPresentsLeft presents left, kept in memory.
+	A slide only ever collects presents, so these sets are closed under all moves and are computed the same way, by increasing number of presents.
+	The sets with the same number of presents are numbered in colexicographic order, which is the order of their values, so the index of a set
+	is the number of sets with fewer presents plus the sum of binomial(position, rank) over its presents.
+	With maxPresentsLeft = 0, this is exactly what the DistanceOracle knows, and each additional present multiplies its size by about PRESENT_COUNT / maxPresentsLeft.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+class EndgameDatabase {
+public:
+	static constexpr std::uint32_t UNREACHABLE = Tablebase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE;
+
+	EndgameDatabase(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::size_t const& maxPresentsLeft) : m_stopCellCount(board.getStopCellCount()), m_maxPresentsLeft(std::min(maxPresentsLeft, PRESENT_COUNT)), m_binomials((PRESENT_COUNT + 1) * (m_maxPresentsLeft + 2), 0), m_offsets(m_maxPresentsLeft + 2, 0), m_entries() {
+		for (std::size_t n = 0; n <= PRESENT_COUNT; ++n) {
+			getBinomial(n, 0) = 1;
+			for (std::size_t k = 1; (k <= n) && (k <= m_maxPresentsLeft + 1); ++k) {
+				getBinomial(n, k) = ((k < n) ? getBinomial(n - 1, k) : 0) + getBinomial(n - 1, k - 1);
+			}
+		}
+		for (std::size_t presentsLeft = 0; presentsLeft <= m_maxPresentsLeft; ++presentsLeft) {
+			m_offsets[presentsLeft + 1] = m_offsets[presentsLeft] + getBinomial(PRESENT_COUNT, presentsLeft);
+		}
+
+		auto const beginBuild = std::chrono::steady_clock::now();
+		m_entries.resize(getEntryCount());
+		build(board);
+		auto const endBuild = std::chrono::steady_clock::now();
+		std::cout << "Endgame database: built " << getEntryCount() << " entries for up to " << m_maxPresentsLeft << " presents left in " << std::chrono::duration_cast<std::chrono::milliseconds>(endBuild - beginBuild).count() << " ms." << std::endl;
+	}
+	~EndgameDatabase() {
+		//
+	}
+
+	inline bool isCovered(std::bitset<PRESENT_COUNT> const& presentState) const {
+		return presentState.count() <= m_maxPresentsLeft;
+	}
+
+	// The exact number of moves left, UNREACHABLE if the state can not be finished at all. Only for states that are covered.
+	inline std::uint32_t getDistance(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		std::uint8_t const entry = m_entries[getIndex(stopCell, presentState)];
+		return (entry == Tablebase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::TABLE_UNREACHABLE) ? UNREACHABLE : entry;
+	}
+
+	/*
+		Collecting more presents never takes fewer moves, so the distance for any subset of the presents left is a lower bound for the state.
+		Covered states get their exact distance, all others the largest distance of the chunks of maxPresentsLeft presents their presents split into.
+	*/
+	inline std::uint32_t getLowerBound(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		if (isCovered(presentState)) {
+			return getDistance(stopCell, presentState);
+		}
+		std::uint32_t result = 0;
+		std::uint64_t bits = presentState.to_ullong();
+		std::uint64_t chunk = 0;
+		std::size_t chunkSize = 0;
+		for (std::uint64_t present = 1; bits != 0; present <<= 1) {
+			if ((bits & present) == 0) {
+				continue;
+			}
+			bits ^= present;
+			chunk |= present;
+			++chunkSize;
+			if ((chunkSize == m_maxPresentsLeft) || (bits == 0)) {
+				result = std::max(result, getDistance(stopCell, std::bitset<PRESENT_COUNT>(chunk)));
+				chunk = 0;
+				chunkSize = 0;
+			}
+		}
+		return result;
+	}
+
+	// A shortest solution from a covered state, see Tablebase::followDistances().
+	std::string getMovesToTarget(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		return Tablebase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::followDistances(board, stopCell, presentState, [this](std::size_t const& cell, std::bitset<PRESENT_COUNT> const& state) { return getDistance(cell, state); });
+	}
+
+	inline std::size_t getMaxPresentsLeft() const {
+		return m_maxPresentsLeft;
+	}
+
+	inline std::size_t getEntryCount() const {
+		return static_cast<std::size_t>(m_offsets[m_maxPresentsLeft + 1]) * m_stopCellCount;
+	}
+private:
+	inline std::uint64_t& getBinomial(std::size_t const& n, std::size_t const& k) {
+		return m_binomials[n * (m_maxPresentsLeft + 2) + k];
+	}
+	inline std::uint64_t getBinomial(std::size_t const& n, std::size_t const& k) const {
+		return m_binomials[n * (m_maxPresentsLeft + 2) + k];
+	}
+
+	inline std::uint64_t getSetIndex(std::bitset<PRESENT_COUNT> const& presentState) const {
+		std::uint64_t bits = presentState.to_ullong();
+		std::uint64_t result = 0;
+		std::size_t rank = 0;
+		for (std::size_t position = 0; bits != 0; ++position, bits >>= 1) {
+			if (bits & 1u) {
+				++rank;
+				result += getBinomial(position, rank);
+			}
+		}
+		return m_offsets[rank] + result;
+	}
+
+	inline std::size_t getIndex(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		return static_cast<std::size_t>(getSetIndex(presentState)) * m_stopCellCount + stopCell;
+	}
+
+	void build(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board) {
+		std::vector<std::pair<std::uint8_t, std::uint32_t>> starts;
+		std::vector<std::pair<std::uint8_t, std::uint32_t>> queue;
+		auto const childEntry = [this](std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& childState) {
+			return m_entries[getIndex(stopCell, childState)];
+		};
+
+		for (std::size_t presentsLeft = 0; presentsLeft <= m_maxPresentsLeft; ++presentsLeft) {
+			// All sets with this many presents, in increasing order, by Gosper's hack
+			std::uint64_t bits = (presentsLeft == 0) ? 0 : (std::numeric_limits<std::uint64_t>::max() >> (64 - presentsLeft));
+			for (std::uint64_t setIndex = m_offsets[presentsLeft]; setIndex < m_offsets[presentsLeft + 1]; ++setIndex) {
+				Tablebase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::solveLayer(board, std::bitset<PRESENT_COUNT>(bits), m_entries.data() + setIndex * m_stopCellCount, childEntry, starts, queue);
+				if ((bits != 0) && (setIndex + 1 < m_offsets[presentsLeft + 1])) {
+					std::uint64_t const lowest = bits & (~bits + 1);
+					std::uint64_t const ripple = bits + lowest;
+					bits = (((ripple ^ bits) >> 2) / lowest) | ripple;
+				}
+			}
+		}
+	}
+
+	std::size_t const m_stopCellCount;
+	std::size_t const m_maxPresentsLeft;
+	// binomial(n, k) for all n <= PRESENT_COUNT and k <= m_maxPresentsLeft + 1
+	std::vector<std::uint64_t> m_binomials;
+	// The index of the first set with the given number of presents
+	std::vector<std::uint64_t> m_offsets;
+	std::vector<std::uint8_t> m_entries;
+};
+
+#endif
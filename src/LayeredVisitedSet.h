@@ -0,0 +1,86 @@
+#ifndef LAYEREDVISITEDSET_H_
+#define LAYEREDVISITEDSET_H_
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+	A visited set for searches that do not discover states in order of their depth, like A*.
+	A state is only dominated by a state on the same cell with a subset of its presents left that was reached in at most as many moves,
+	so the values are kept in one VISITED_SET per depth and a query checks all layers up to the given depth.
+	They are checked from the deepest one downwards, as a dominating state is most often found among the recently reached ones.
+	Inserting evicts the dominated supersets from the layer of its depth and from all deeper ones, which drops layers that become empty.
+	VISITED_SET needs hasValue(), evictSupersets() and size() for this, see AntichainSet.
+*/
+template <typename VISITED_SET>
+class LayeredVisitedSet {
+public:
+	LayeredVisitedSet() : m_depths(), m_layers() {
+		//
+	}
+	~LayeredVisitedSet() {
+		//
+	}
+
+	template <std::size_t BIT_COUNT>
+	bool hasValueOrSubsetThereof(std::bitset<BIT_COUNT> const& value, std::uint32_t const& depth) const {
+		std::size_t i = static_cast<std::size_t>(std::upper_bound(m_depths.cbegin(), m_depths.cend(), depth) - m_depths.cbegin());
+		while (i > 0) {
+			--i;
+			if (m_layers[i].hasValueOrSubsetThereof(value)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/*
+		Whether exactly this value is still stored for the given depth. As every dominating insert evicts it, a value inserted before
+		is gone once the same depth or a lower one got a subset of it, or a lower one got the value itself.
+	*/
+	template <std::size_t BIT_COUNT>
+	bool hasValue(std::bitset<BIT_COUNT> const& value, std::uint32_t const& depth) const {
+		auto const it = std::lower_bound(m_depths.cbegin(), m_depths.cend(), depth);
+		return (it != m_depths.cend()) && (*it == depth) && m_layers[static_cast<std::size_t>(it - m_depths.cbegin())].hasValue(value);
+	}
+
+	template <std::size_t BIT_COUNT>
+	void insertValueEvictingSupersets(std::bitset<BIT_COUNT> const& value, std::uint32_t const& depth) {
+		auto const it = std::lower_bound(m_depths.begin(), m_depths.end(), depth);
+		std::size_t const index = static_cast<std::size_t>(it - m_depths.begin());
+		if ((it == m_depths.end()) || (*it != depth)) {
+			m_depths.insert(it, depth);
+			m_layers.insert(m_layers.begin() + index, VISITED_SET());
+		}
+		m_layers[index].insertValueEvictingSupersets(value);
+
+		// Deeper layers lose the value itself, too
+		std::size_t kept = index + 1;
+		for (std::size_t i = index + 1; i < m_layers.size(); ++i) {
+			m_layers[i].evictSupersets(value);
+			if (m_layers[i].size() > 0) {
+				if (kept != i) {
+					m_depths[kept] = m_depths[i];
+					m_layers[kept] = std::move(m_layers[i]);
+				}
+				++kept;
+			}
+		}
+		m_depths.resize(kept);
+		m_layers.resize(kept);
+	}
+
+	template<class Archive>
+	void serialize(Archive& archive) {
+		archive(m_depths, m_layers);
+	}
+private:
+	// Sorted ascending, m_layers[i] holds the values reached in m_depths[i] moves.
+	std::vector<std::uint32_t> m_depths;
+	std::vector<VISITED_SET> m_layers;
+};
+
+#endif
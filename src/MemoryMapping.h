@@ -0,0 +1,138 @@
+#ifndef MEMORYMAPPING_H_
+#define MEMORYMAPPING_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/*
+	Zero-initialized memory taken directly from the OS.
+	Pages are only backed by physical memory once they are touched, so large and sparsely used arrays only cost what is actually used.
+	Alternatively, a file of the given size mapped into memory: writes go to the file, and the OS pages it in and out on demand, so it may be larger than the physical memory.
+*/
+class MemoryMapping {
+public:
+	MemoryMapping() : m_data(nullptr), m_size(0), m_isFile(false) {
+		//
+	}
+	explicit MemoryMapping(std::size_t const& size) : m_data(nullptr), m_size(size), m_isFile(false) {
+		if (m_size == 0) {
+			return;
+		}
+#ifdef _WIN32
+		m_data = VirtualAlloc(nullptr, m_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		if (m_data == nullptr) {
+#else
+		m_data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (m_data == MAP_FAILED) {
+#endif
+			std::cerr << "Failed to map " << m_size << " bytes of memory!" << std::endl;
+			exit(-1);
+		}
+	}
+	/*
+		Maps the file, which has to be exactly size bytes long if it is only read.
+		If it is writable, the file is created or truncated, and grown to size bytes, which read as zero until written.
+	*/
+	MemoryMapping(std::string const& filename, std::size_t const& size, bool const& isWritable) : m_data(nullptr), m_size(size), m_isFile(true) {
+		if (m_size == 0) {
+			return;
+		}
+#ifdef _WIN32
+		HANDLE const file = CreateFileA(filename.c_str(), isWritable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ, nullptr, isWritable ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			std::cerr << "Failed to open '" << filename << "' for mapping!" << std::endl;
+			exit(-1);
+		}
+		ULARGE_INTEGER mappingSize;
+		mappingSize.QuadPart = m_size;
+		HANDLE const mapping = CreateFileMappingA(file, nullptr, isWritable ? PAGE_READWRITE : PAGE_READONLY, mappingSize.HighPart, mappingSize.LowPart, nullptr);
+		if (mapping != nullptr) {
+			m_data = MapViewOfFile(mapping, isWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, m_size);
+			// The view keeps both alive
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+		if (m_data == nullptr) {
+#else
+		int const file = open(filename.c_str(), isWritable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+		if (file == -1) {
+			std::cerr << "Failed to open '" << filename << "' for mapping!" << std::endl;
+			exit(-1);
+		}
+		if (isWritable && (ftruncate(file, static_cast<off_t>(m_size)) != 0)) {
+			std::cerr << "Failed to grow '" << filename << "' to " << m_size << " bytes!" << std::endl;
+			exit(-1);
+		}
+		m_data = mmap(nullptr, m_size, isWritable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, file, 0);
+		// The mapping keeps the file alive
+		close(file);
+		if (m_data == MAP_FAILED) {
+			m_data = nullptr;
+#endif
+			std::cerr << "Failed to map " << m_size << " bytes of '" << filename << "'!" << std::endl;
+			exit(-1);
+		}
+	}
+	MemoryMapping(MemoryMapping const& other) = delete;
+	MemoryMapping& operator=(MemoryMapping const& other) = delete;
+	MemoryMapping(MemoryMapping&& other) noexcept : m_data(other.m_data), m_size(other.m_size), m_isFile(other.m_isFile) {
+		other.m_data = nullptr;
+		other.m_size = 0;
+	}
+	MemoryMapping& operator=(MemoryMapping&& other) noexcept {
+		if (this != &other) {
+			unmap();
+			m_data = other.m_data;
+			m_size = other.m_size;
+			m_isFile = other.m_isFile;
+			other.m_data = nullptr;
+			other.m_size = 0;
+		}
+		return *this;
+	}
+	~MemoryMapping() {
+		unmap();
+	}
+
+	void* getData() const {
+		return m_data;
+	}
+
+	std::size_t getSize() const {
+		return m_size;
+	}
+private:
+	void unmap() {
+		if (m_data != nullptr) {
+#ifdef _WIN32
+			if (m_isFile) {
+				UnmapViewOfFile(m_data);
+			} else {
+				VirtualFree(m_data, 0, MEM_RELEASE);
+			}
+#else
+			munmap(m_data, m_size);
+#endif
+			m_data = nullptr;
+		}
+	}
+
+	void* m_data;
+	std::size_t m_size;
+	bool m_isFile;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef PACKEDSTATE_H_
+#define PACKEDSTATE_H_
+
+#include <bitset>
+#include <cstdint>
+#include <limits>
+
+/*
+	A search state (penguin position + presents still on the board) packed into one 64-bit word.
+	The lowest PRESENT_COUNT bits hold the present state, the position is stored above them.
+*/
+template <std::size_t CELL_COUNT, std::size_t PRESENT_COUNT>
+class PackedState {
+public:
+	static constexpr std::size_t bitsRequiredFor(std::size_t value) {
+		std::size_t result = 1;
+		while ((result < 64) && ((value >> result) != 0)) {
+			++result;
+		}
+		return result;
+	}
+
+	static constexpr std::size_t POSITION_BITS = bitsRequiredFor(CELL_COUNT - 1);
+	static constexpr std::size_t TOTAL_BITS = POSITION_BITS + PRESENT_COUNT;
+	static_assert(TOTAL_BITS <= 64, "Position and present state do not fit into 64 bits.");
+
+	PackedState() : m_value(0) {
+		//
+	}
+
+	PackedState(std::size_t const& pos, std::bitset<PRESENT_COUNT> const& presentState) : m_value((static_cast<std::uint64_t>(pos) << PRESENT_COUNT) | static_cast<std::uint64_t>(presentState.to_ullong())) {
+		//
+	}
+
+	inline std::size_t getPos() const noexcept(true) {
+		return static_cast<std::size_t>(m_value >> PRESENT_COUNT);
+	}
+
+	inline std::bitset<PRESENT_COUNT> getPresentState() const noexcept(true) {
+		if constexpr (PRESENT_COUNT == 0) {
+			return std::bitset<PRESENT_COUNT>();
+		} else {
+			return std::bitset<PRESENT_COUNT>(m_value & PRESENT_MASK);
+		}
+	}
+
+	inline std::uint64_t getValue() const noexcept(true) {
+		return m_value;
+	}
+
+	template<class Archive>
+	void serialize(Archive& archive) {
+		archive(m_value);
+	}
+private:
+	static constexpr std::uint64_t PRESENT_MASK = (PRESENT_COUNT >= 64) ? std::numeric_limits<std::uint64_t>::max() : ((std::uint64_t(1) << (PRESENT_COUNT % 64)) - 1);
+
+	std::uint64_t m_value;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/*
+	Runs function(threadIndex) on threadCount threads, the calling thread acts as thread 0.
+	Returns once all threads are done.
+*/
+template<typename F>
+void runOnThreads(std::size_t const& threadCount, F const& function) {
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for (std::size_t i = 1; i < threadCount; ++i) {
+		threads.emplace_back(function, i);
+	}
+	function(0);
+	for (auto it = threads.begin(); it != threads.end(); ++it) {
+		it->join();
+	}
+}
+
+/*
+	Splits [begin, end) into threadCount consecutive chunks and returns the bounds of chunk threadIndex.
+*/
+inline std::pair<std::size_t, std::size_t> getChunkForThread(std::size_t const& begin, std::size_t const& end, std::size_t const& threadIndex, std::size_t const& threadCount) {
+	std::size_t const count = end - begin;
+	std::size_t const chunkBegin = begin + (count * threadIndex) / threadCount;
+	std::size_t const chunkEnd = begin + (count * (threadIndex + 1)) / threadCount;
+	return std::make_pair(chunkBegin, chunkEnd);
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef PATTERNDATABASE_H_
+#define PATTERNDATABASE_H_
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/archives/binary.hpp>
+
+#include "Board.h"
+#include "DistanceOracle.h"
+
+/*
+	Pattern databases over groups of presents, as a lower bound for the remaining moves of a state.
+	The presents are split into groups of consecutive indices. For every group, a table holds for every stop cell and every subset of the group
+	the exact number of moves needed to collect that subset and then reach a target, ignoring all presents outside the group.
+	One slide can collect presents of several groups at once, so the tables can not be added up, the lower bound is their maximum instead.
+	Each table is an exact distance in a relaxed game and therefore consistent, and so is the maximum.
+	With single presents as groups, this is PresentDistances.
+
+	The tables only depend on the stop cell graph, so they are written to a file named after a fingerprint of that graph and the group size
+	in the working directory and loaded from there by later runs on the same board.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+class PatternDatabase {
+public:
+	static constexpr std::uint32_t UNREACHABLE = DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE;
+	static constexpr std::size_t MAX_GROUP_SIZE = 16;
+
+	PatternDatabase(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, std::size_t const& groupSize) : m_oracle(oracle), m_groupSize(std::clamp<std::size_t>(groupSize, 1, MAX_GROUP_SIZE)), m_tables() {
+		std::uint64_t const fingerprint = board.getFingerprint();
+		std::stringstream filename;
+		filename << "pdb_" << std::hex << std::setw(16) << std::setfill('0') << fingerprint << std::dec << "_" << m_groupSize << ".bin";
+
+		if (load(filename.str(), fingerprint, board.getStopCellCount())) {
+			std::cout << "Pattern database: loaded " << getGroupCount() << " tables from '" << filename.str() << "'." << std::endl;
+			return;
+		}
+
+		auto const beginBuild = std::chrono::steady_clock::now();
+		for (std::size_t groupBegin = 0; groupBegin < PRESENT_COUNT; groupBegin += m_groupSize) {
+			m_tables.push_back(buildTable(board, groupBegin, std::min(m_groupSize, PRESENT_COUNT - groupBegin)));
+		}
+		auto const endBuild = std::chrono::steady_clock::now();
+		std::cout << "Pattern database: built " << getGroupCount() << " tables in " << std::chrono::duration_cast<std::chrono::milliseconds>(endBuild - beginBuild).count() << " ms";
+
+		std::ofstream os(filename.str(), std::ios::binary);
+		if (os) {
+			cereal::BinaryOutputArchive archive(os);
+			archive(fingerprint, m_groupSize, m_tables);
+			std::cout << ", saved to '" << filename.str() << "'." << std::endl;
+		} else {
+			std::cout << "." << std::endl;
+			std::cerr << "Failed to write the pattern database to '" << filename.str() << "'!" << std::endl;
+		}
+	}
+	~PatternDatabase() {
+		//
+	}
+
+	inline std::size_t getGroupCount() const {
+		return m_tables.size();
+	}
+
+	/*
+		The lower bound for the remaining moves of the state, UNREACHABLE if the state can not be finished at all.
+		For states without presents left, this is the exact remaining distance.
+	*/
+	inline std::uint32_t getLowerBound(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		std::uint32_t result = m_oracle.getDistance(stopCell);
+		if constexpr (PRESENT_COUNT > 0) {
+			std::uint64_t const bits = presentState.to_ullong();
+			std::size_t groupBegin = 0;
+			for (auto it = m_tables.cbegin(); it != m_tables.cend(); ++it, groupBegin += m_groupSize) {
+				std::size_t const groupBits = std::min(m_groupSize, PRESENT_COUNT - groupBegin);
+				std::uint64_t const groupMask = (bits >> groupBegin) & ((std::uint64_t(1) << groupBits) - 1);
+				std::uint16_t const distance = (*it)[(stopCell << groupBits) | groupMask];
+				if (distance == TABLE_UNREACHABLE) {
+					return UNREACHABLE;
+				}
+				result = std::max<std::uint32_t>(result, distance);
+			}
+		}
+		return result;
+	}
+private:
+	static constexpr std::uint16_t TABLE_UNREACHABLE = 0xFFFF;
+
+	/*
+		A BFS backwards from the targets over the states (stop cell, presents of the group left).
+		A slide from origin to stopCell leaving the presents m of the group can start with m plus any of the group presents it collects on the way.
+		Distances that do not fit are stored as TABLE_UNREACHABLE - 1, which keeps the bound admissible.
+	*/
+	static std::vector<std::uint16_t> buildTable(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::size_t const& groupBegin, std::size_t const& groupBits) {
+		std::size_t const stopCellCount = board.getStopCellCount();
+		std::uint64_t const localMask = (std::uint64_t(1) << groupBits) - 1;
+		std::vector<std::uint16_t> result(stopCellCount << groupBits, TABLE_UNREACHABLE);
+		// Entries are (stop cell << groupBits) | present mask, the same as the table index.
+		std::vector<std::size_t> queue;
+		for (std::size_t stopCell = 0; stopCell < stopCellCount; ++stopCell) {
+			if (board.isTargetStopCell(stopCell)) {
+				result[stopCell << groupBits] = 0;
+				queue.push_back(stopCell << groupBits);
+			}
+		}
+
+		for (std::size_t head = 0; head < queue.size(); ++head) {
+			std::size_t const stopCell = queue[head] >> groupBits;
+			std::uint64_t const presentsLeft = queue[head] & localMask;
+			std::uint16_t const distance = std::min<std::uint16_t>(result[queue[head]] + 1, TABLE_UNREACHABLE - 1);
+			for (auto it = board.getStopCellPredecessorsBegin(stopCell); it != board.getStopCellPredecessorsEnd(stopCell); ++it) {
+				std::uint64_t const collected = ((~it->keepMask.to_ullong()) >> groupBegin) & localMask;
+				if ((presentsLeft & collected) != 0) {
+					continue;
+				}
+				// All subsets of collected, including the empty one
+				std::uint64_t subset = collected;
+				while (true) {
+					std::size_t const index = (static_cast<std::size_t>(it->origin) << groupBits) | presentsLeft | subset;
+					if (result[index] == TABLE_UNREACHABLE) {
+						result[index] = distance;
+						queue.push_back(index);
+					}
+					if (subset == 0) {
+						break;
+					}
+					subset = (subset - 1) & collected;
+				}
+			}
+		}
+		return result;
+	}
+
+	bool load(std::string const& filename, std::uint64_t const& fingerprint, std::size_t const& stopCellCount) {
+		if (!std::filesystem::exists(filename)) {
+			return false;
+		}
+		std::ifstream is(filename, std::ios::binary);
+		cereal::BinaryInputArchive archive(is);
+		std::uint64_t fileFingerprint = 0;
+		std::size_t fileGroupSize = 0;
+		std::vector<std::vector<std::uint16_t>> tables;
+		try {
+			archive(fileFingerprint, fileGroupSize, tables);
+		} catch (cereal::Exception const&) {
+			std::cerr << "Failed to read the pattern database from '" << filename << "', rebuilding it." << std::endl;
+			return false;
+		}
+		if ((fileFingerprint != fingerprint) || (fileGroupSize != m_groupSize)) {
+			std::cerr << "The pattern database in '" << filename << "' does not belong to this board, rebuilding it." << std::endl;
+			return false;
+		}
+		bool isValid = tables.size() == ((PRESENT_COUNT + m_groupSize - 1) / m_groupSize);
+		std::size_t groupBegin = 0;
+		for (auto it = tables.cbegin(); isValid && (it != tables.cend()); ++it, groupBegin += m_groupSize) {
+			isValid = it->size() == (stopCellCount << std::min(m_groupSize, PRESENT_COUNT - groupBegin));
+		}
+		if (!isValid) {
+			std::cerr << "The pattern database in '" << filename << "' is damaged, rebuilding it." << std::endl;
+			return false;
+		}
+		m_tables = std::move(tables);
+		return true;
+	}
+
+	DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& m_oracle;
+	std::size_t const m_groupSize;
+	std::vector<std::vector<std::uint16_t>> m_tables;
+};
+
+#endif
@@ -6,10 +6,20 @@
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
+#include <optional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
-#include "Trie.h"
+#include "AntichainSet.h"
+#include "DistanceOracle.h"
+#include "EndgameDatabase.h"
+#include "Parallel.h"
+#include "PlayNonOptimal.h"
+#include "PredecessorLog.h"
+#include "PresentDistances.h"
+#include "SearchOptions.h"
+#include "StateBackup.h"
 
 #include "lz4_stream.h"
 
@@ -18,14 +28,14 @@ inline bool ends_with(std::string const& value, std::string const& ending) {
 	return std::equal(ending.rbegin(), ending.rend(), value.rbegin());
 }
 
-template<std::size_t PRESENT_COUNT>
-void checkForFinalStates(std::vector<Trie<PRESENT_COUNT>> const& knownPositions) {
+template<std::size_t PRESENT_COUNT, typename VISITED_SET>
+void checkForFinalStates(std::vector<VISITED_SET> const& knownPositions) {
 	if constexpr(PRESENT_COUNT > 0) {
 		auto const allZeroBitset = std::bitset<PRESENT_COUNT>();
 		std::size_t totalStates = 0;
 		std::size_t statesWithAllPresents = 0;
 		for (auto itO = knownPositions.cbegin(); itO != knownPositions.cend(); ++itO) {
-			Trie<PRESENT_COUNT> const& trie = *itO;
+			VISITED_SET const& trie = *itO;
 			++totalStates;
 			if (trie.hasValueOrSubsetThereof(allZeroBitset)) {
 				++statesWithAllPresents;
@@ -35,32 +45,192 @@ void checkForFinalStates(std::vector<Trie<PRESENT_COUNT>> const& knownPositions)
 	}
 }
 
-template<std::size_t NUM_ROWS, std::size_t NUM_COLS, std::size_t PRESENT_COUNT>
-inline void updateStack(std::vector<Trie<PRESENT_COUNT>>& knownPositions, std::queue<QueueObject<PRESENT_COUNT>>& penguinPositions, QueueObject<PRESENT_COUNT> const& p, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const& localOverlay, std::size_t const& newPos, char direction) {
-	if (!knownPositions[newPos].hasValueOrSubsetThereof(localOverlay.getRepresentation())) {
-		knownPositions[newPos].insertValue(localOverlay.getRepresentation());
-		penguinPositions.push(p.moveTo(newPos, localOverlay.getRepresentation(), direction));
+template<std::size_t CELL_COUNT, std::size_t PRESENT_COUNT, typename VISITED_SET>
+inline void updateStack(std::vector<VISITED_SET>& knownPositions, PredecessorLog<CELL_COUNT, PRESENT_COUNT>& penguinPositions, std::size_t const& parentIndex, PackedState<CELL_COUNT, PRESENT_COUNT> const& p, StopCellEdge<PRESENT_COUNT> const& edge) {
+	std::bitset<PRESENT_COUNT> const presentState = p.getPresentState() & edge.keepMask;
+	if (!knownPositions[edge.target].hasValueOrSubsetThereof(presentState)) {
+		knownPositions[edge.target].insertValueEvictingSupersets(presentState);
+		penguinPositions.add(PackedState<CELL_COUNT, PRESENT_COUNT>(edge.target, presentState), parentIndex, edge.direction);
 	}
 }
 
+template<std::size_t CELL_COUNT, std::size_t PRESENT_COUNT>
+struct ExpansionCandidate {
+public:
+	ExpansionCandidate(PackedState<CELL_COUNT, PRESENT_COUNT> const& state, std::size_t const& parentIndex, Direction const& direction) : state(state), parentIndex(parentIndex), direction(direction), isAccepted(false) {
+		//
+	}
+
+	PackedState<CELL_COUNT, PRESENT_COUNT> state;
+	std::size_t parentIndex;
+	Direction direction;
+	bool isAccepted;
+};
+
+template<std::size_t CELL_COUNT, std::size_t PRESENT_COUNT, typename VISITED_SET>
+inline void addCandidate(std::vector<VISITED_SET> const& knownPositions, std::size_t const& parentIndex, PackedState<CELL_COUNT, PRESENT_COUNT> const& p, StopCellEdge<PRESENT_COUNT> const& edge, std::vector<ExpansionCandidate<CELL_COUNT, PRESENT_COUNT>>& candidates) {
+	std::bitset<PRESENT_COUNT> const presentState = p.getPresentState() & edge.keepMask;
+	if (!knownPositions[edge.target].hasValueOrSubsetThereof(presentState)) {
+		candidates.push_back(ExpansionCandidate<CELL_COUNT, PRESENT_COUNT>(PackedState<CELL_COUNT, PRESENT_COUNT>(edge.target, presentState), parentIndex, edge.direction));
+	}
+}
+
+// The lower bound successors are checked against: the one of the endgame database if given, which is exact for the states it covers, else the distance for collecting each single present if given, which is only worth its cost with an upper bound from the start.
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+inline std::uint32_t getSuccessorLowerBound(DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, PresentDistances<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const* presentDistances, EndgameDatabase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const* endgame, std::bitset<PRESENT_COUNT> const& presentState, StopCellEdge<PRESENT_COUNT> const& edge) {
+	if (endgame != nullptr) {
+		return endgame->getLowerBound(edge.target, presentState & edge.keepMask);
+	}
+	if (presentDistances == nullptr) {
+		return oracle.getDistance(edge.target);
+	}
+	return presentDistances->getLowerBound(edge.target, presentState & edge.keepMask);
+}
+
+// States without presents left, or with few enough for the endgame database, are finished by a table lookup and never expanded.
 template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
-std::size_t play(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, bool deleteOldBackups, bool noBackups, std::string const& stateFilename = "") {
+inline bool isFinishedByLookup(EndgameDatabase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const* endgame, std::bitset<PRESENT_COUNT> const& presentState) {
+	return presentState.none() || ((endgame != nullptr) && endgame->isCovered(presentState));
+}
+
+// Whether a VISITED_SET declares SHARES_STATE_ACROSS_INSTANCES = true, i.e. different instances can not be modified concurrently.
+template<typename VISITED_SET, typename = void>
+struct SharesStateAcrossInstances : std::false_type {};
+
+template<typename VISITED_SET>
+struct SharesStateAcrossInstances<VISITED_SET, std::void_t<decltype(VISITED_SET::SHARES_STATE_ACROSS_INSTANCES)>> : std::bool_constant<VISITED_SET::SHARES_STATE_ACROSS_INSTANCES> {};
+
+/*
+	Expands all queue entries in [batchBegin, batchEnd) using multiple threads, skipping the ones that are finished by a lookup, see isFinishedByLookup(),
+	and all successors whose lower bound does not stay below distanceLimit. Target stop cells have no edges, so they expand to nothing.
+	The result is exactly the same as calling updateStack on every remaining successor in queue order:
+	1. Every thread expands a consecutive chunk of the batch and pre-filters the successors against the visited sets, which are only read in this phase.
+	2. Every thread owns a subset of the stop cells and re-checks and inserts the candidates for its cells in queue order. Visited sets sharing state across instances are merged by one thread.
+	3. The accepted candidates are appended to the log in queue order.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename VISITED_SET>
+void expandInParallel(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, PresentDistances<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const* presentDistances, EndgameDatabase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const* endgame, std::uint32_t const& distanceLimit, std::vector<VISITED_SET>& knownPositions, PredecessorLog<NUM_ROWS * NUM_COLS, PRESENT_COUNT>& penguinPositions, std::size_t const& batchBegin, std::size_t const& batchEnd, std::size_t const& threadCount, std::vector<std::vector<ExpansionCandidate<NUM_ROWS * NUM_COLS, PRESENT_COUNT>>>& candidates) {
+	runOnThreads(threadCount, [&](std::size_t threadIndex) {
+		auto const chunk = getChunkForThread(batchBegin, batchEnd, threadIndex, threadCount);
+		std::vector<ExpansionCandidate<NUM_ROWS * NUM_COLS, PRESENT_COUNT>>& localCandidates = candidates[threadIndex];
+		localCandidates.clear();
+		for (std::size_t index = chunk.first; index < chunk.second; ++index) {
+			PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const& p = penguinPositions.getState(index);
+			if (isFinishedByLookup(endgame, p.getPresentState())) {
+				continue;
+			}
+			for (auto it = board.getStopCellEdgesBegin(p.getPos()); it != board.getStopCellEdgesEnd(p.getPos()); ++it) {
+				if (getSuccessorLowerBound(oracle, presentDistances, endgame, p.getPresentState(), *it) < distanceLimit) {
+					addCandidate(knownPositions, index, p, *it, localCandidates);
+				}
+			}
+		}
+	});
+
+	std::size_t const mergeThreadCount = SharesStateAcrossInstances<VISITED_SET>::value ? 1 : threadCount;
+	runOnThreads(mergeThreadCount, [&](std::size_t threadIndex) {
+		for (auto itO = candidates.begin(); itO != candidates.end(); ++itO) {
+			for (auto it = itO->begin(); it != itO->end(); ++it) {
+				std::size_t const pos = it->state.getPos();
+				if ((pos % mergeThreadCount) != threadIndex) {
+					continue;
+				}
+				std::bitset<PRESENT_COUNT> const presentState = it->state.getPresentState();
+				if (!knownPositions[pos].hasValueOrSubsetThereof(presentState)) {
+					knownPositions[pos].insertValueEvictingSupersets(presentState);
+					it->isAccepted = true;
+				}
+			}
+		}
+	});
+
+	for (auto itO = candidates.cbegin(); itO != candidates.cend(); ++itO) {
+		for (auto it = itO->cbegin(); it != itO->cend(); ++it) {
+			if (it->isAccepted) {
+				penguinPositions.add(it->state, it->parentIndex, it->direction);
+			}
+		}
+	}
+}
+
+// Every state backup of play() starts with STATE_BACKUP_TAG, STATE_BACKUP_VERSION and the getName() of its VISITED_SET, as only that type can read the visited sets back.
+// The tag spells "PenguinB", which can not be mistaken for the number of presents left older backups start with.
+static constexpr std::uint64_t STATE_BACKUP_TAG = 0x50656e6775696e42ull;
+static constexpr std::uint32_t STATE_BACKUP_VERSION = 3;
+
+/*
+	Reads the head of a state backup of play() and returns the name of the visited set it was written with.
+	Exits if the file is no such backup, which includes the ones written before the head was introduced, or has a different version.
+*/
+inline std::string readStateBackupHead(cereal::BinaryInputArchive& archive, std::string const& filename) {
+	std::uint64_t tag = 0;
+	try {
+		archive(tag);
+	} catch (cereal::Exception const&) {
+		tag = 0;
+	}
+	if (tag != STATE_BACKUP_TAG) {
+		std::cerr << "The file '" << filename << "' is no state backup of this version, it does not record its visited set!" << std::endl;
+		exit(-1);
+	}
+	std::uint32_t version = 0;
+	std::string visitedSetName;
+	archive(version, visitedSetName);
+	if (version != STATE_BACKUP_VERSION) {
+		std::cerr << "The state backup '" << filename << "' has version " << version << ", but only version " << STATE_BACKUP_VERSION << " can be read!" << std::endl;
+		exit(-1);
+	}
+	return visitedSetName;
+}
+
+// The name of the visited set the state backup was written with, see readStateBackupHead().
+inline std::string getStateBackupVisitedSet(std::string const& filename) {
+	std::ifstream is(filename, std::ios::binary);
+	lz4_stream::istream compressedStream(is);
+	cereal::BinaryInputArchive archive(compressedStream);
+	return readStateBackupHead(archive, filename);
+}
+
+/*
+	VISITED_SET is the per-cell set of present states already seen. It needs to provide hasValueOrSubsetThereof(), insertValue(), insertValueEvictingSupersets(), serialize() and getName(), see Trie.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename VISITED_SET = AntichainSet<PRESENT_COUNT>>
+std::size_t play(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
 	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections);
 	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> board = init.first;
-	PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> presentOverlay = init.second;
+	PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const& presentOverlay = init.second;
+	DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const oracle(board);
+	std::optional<PresentDistances<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>> presentDistancesStorage;
+	PresentDistances<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const* presentDistances = nullptr;
+	if (options.useGreedyBound) {
+		presentDistancesStorage.emplace(board, oracle);
+		presentDistances = &presentDistancesStorage.value();
+	}
+	std::optional<EndgameDatabase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>> endgameStorage;
+	EndgameDatabase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const* endgame = nullptr;
+	if (options.endgamePresentCount > 0) {
+		endgameStorage.emplace(board, options.endgamePresentCount);
+		endgame = &endgameStorage.value();
+	}
 
-	std::queue<QueueObject<PRESENT_COUNT>> penguinPositions;
-	std::vector<Trie<PRESENT_COUNT>> knownPositions;
+	// Every discovered state, in BFS order. Everything from queueHead onwards is still to be expanded.
+	PredecessorLog<NUM_ROWS * NUM_COLS, PRESENT_COUNT> penguinPositions;
+	std::size_t queueHead = 0;
+	// The BFS level of the entry at queueHead, which ends at levelEnd
+	std::size_t queueDepth = 0;
+	std::size_t levelEnd = 1;
+	std::vector<VISITED_SET> knownPositions;
 
 	knownPositions.clear();
 
-	std::size_t newPos;
-	std::size_t target;
-
 	// Current Min
 	std::size_t currentMinPresentsLeft = std::numeric_limits<std::size_t>::max();
 	std::string currentMinPresentsLeftMoves = "";
 
+	// Shortest known solution, states without presents left are finished using the distance oracle, states with few presents left by the endgame database
+	std::size_t bestSolutionLength = std::numeric_limits<std::size_t>::max();
+	std::string bestSolutionMoves = "";
+
 	// Only print every Nth target, if it is not a record
 	std::size_t const everyNthTarget = 250;
 	std::size_t const everyNthTargetBackup = 100000;
@@ -68,105 +238,136 @@ std::size_t play(std::array<std::string, NUM_ROWS> const& fieldString, std::vect
 	std::string lastBackupFilename = "";
 	std::size_t roundCounter = 0;
 
-	if (!stateFilename.empty() && std::filesystem::exists(stateFilename)) {
+	if (!options.stateFilename.empty() && std::filesystem::exists(options.stateFilename)) {
 		auto const beginBackupLoad = std::chrono::steady_clock::now();
 
-		std::ifstream is(stateFilename, std::ios::binary);
+		std::ifstream is(options.stateFilename, std::ios::binary);
 		lz4_stream::istream compressedStream(is);
 		cereal::BinaryInputArchive archive(compressedStream);
-		archive(currentMinPresentsLeft, currentMinPresentsLeftMoves, targetCounter, roundCounter, penguinPositions, knownPositions);
+		std::string const visitedSetName = readStateBackupHead(archive, options.stateFilename);
+		if (visitedSetName.compare(VISITED_SET::getName()) != 0) {
+			std::cerr << "The state backup '" << options.stateFilename << "' was written with the visited set '" << visitedSetName << "', but '" << VISITED_SET::getName() << "' is selected, resume it with '--visited " << visitedSetName << "' or 'auto'!" << std::endl;
+			exit(-1);
+		}
+		archive(currentMinPresentsLeft, currentMinPresentsLeftMoves, targetCounter, roundCounter, penguinPositions, queueHead, queueDepth, levelEnd, bestSolutionLength, bestSolutionMoves, knownPositions);
 
 		auto const endBackupLoad = std::chrono::steady_clock::now();
-		std::cout << "Loaded state backup at #" << targetCounter << " in " << std::chrono::duration_cast<std::chrono::milliseconds>(endBackupLoad - beginBackupLoad).count() << " ms, stack has " << penguinPositions.size() << " elements." << std::endl;
-		lastBackupFilename = stateFilename;
+		std::cout << "Loaded state backup at #" << targetCounter << " in " << std::chrono::duration_cast<std::chrono::milliseconds>(endBackupLoad - beginBackupLoad).count() << " ms, stack has " << (penguinPositions.size() - queueHead) << " elements." << std::endl;
+		lastBackupFilename = options.stateFilename;
 	} else {
-		for (std::size_t i = 0; i < NUM_ROWS * NUM_COLS; ++i) {
-			knownPositions.push_back(Trie<PRESENT_COUNT>());
+		// Positions are indices into the stop cell graph of the board, so only cells the penguin can rest on get a visited set
+		for (std::size_t i = 0; i < board.getStopCellCount(); ++i) {
+			knownPositions.push_back(VISITED_SET());
 		}
 
-		knownPositions[board.getPenguinStartingPosition()].insertValue(presentOverlay.getRepresentation());
-		penguinPositions.push(QueueObject<PRESENT_COUNT>(board.getPenguinStartingPosition(), presentOverlay.getRepresentation()));
+		knownPositions[board.getStartingStopCell()].insertValue(presentOverlay.getRepresentation());
+		penguinPositions.addRoot(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(board.getStartingStopCell(), presentOverlay.getRepresentation()));
+
+		// Everything that can not beat the greedy solution is dropped right from the start, instead of only once the search found a solution itself
+		if (options.useGreedyBound) {
+			std::string const greedyMoves = findGreedySolution(board, presentOverlay, oracle, options.greedyRuns);
+			if (!greedyMoves.empty()) {
+				bestSolutionLength = greedyMoves.size();
+				bestSolutionMoves = greedyMoves;
+				std::cout << "Greedy upper bound after " << options.greedyRuns << " runs: " << bestSolutionLength << " moves with " << bestSolutionMoves << std::endl;
+			}
+		}
 	}
 
+	// With more than one thread, up to maxBatchSize queue entries are expanded at once
+	std::size_t const maxBatchSize = 1 << 20;
+	std::vector<std::vector<ExpansionCandidate<NUM_ROWS * NUM_COLS, PRESENT_COUNT>>> candidates(options.threadCount);
+
 	auto const beginSearch = std::chrono::steady_clock::now();
-	while (!penguinPositions.empty()) {
-		++roundCounter;
-		QueueObject<PRESENT_COUNT> const& p = penguinPositions.front();
-		
-		if (board.getPieceAt(p.getPos()) == BoardPiece::TARGET) {
-			PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> localOverlay(presentOverlay.getBase(), p.getPresentState());
-			bool isNewRecord = false;
-			if (currentMinPresentsLeft > localOverlay.getPresentsLeft()) {
+	// Nothing at or below the depth of the best solution can improve on it
+	while ((queueHead < penguinPositions.size()) && (queueDepth < bestSolutionLength)) {
+		// Never reaches beyond the current BFS level, so all entries of a batch have the same depth.
+		std::size_t const batchEnd = (options.threadCount > 1) ? std::min(levelEnd, queueHead + maxBatchSize) : (queueHead + 1);
+		for (std::size_t index = queueHead; index < batchEnd; ++index) {
+			++roundCounter;
+			PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const p = penguinPositions.getState(index);
+			if (!board.isTargetStopCell(p.getPos())) {
+				if (p.getPresentState().none()) {
+					std::uint32_t const distance = oracle.getDistance(p.getPos());
+					if ((distance != DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE) && (queueDepth + distance < bestSolutionLength)) {
+						bestSolutionLength = queueDepth + distance;
+						bestSolutionMoves = penguinPositions.getMoves(index) + oracle.getMovesToTarget(board, p.getPos());
+						std::cout << "Collected all presents, the shortest way from there to the target gives a solution with " << bestSolutionLength << " moves: " << bestSolutionMoves << std::endl;
+					}
+				} else if (isFinishedByLookup(endgame, p.getPresentState())) {
+					std::uint32_t const distance = endgame->getDistance(p.getPos(), p.getPresentState());
+					if ((distance != EndgameDatabase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE) && (queueDepth + distance < bestSolutionLength)) {
+						bestSolutionLength = queueDepth + distance;
+						bestSolutionMoves = penguinPositions.getMoves(index) + endgame->getMovesToTarget(board, p.getPos(), p.getPresentState());
+						std::cout << "Reached " << p.getPresentState().count() << " presents left, the endgame database finishes that in a solution with " << bestSolutionLength << " moves: " << bestSolutionMoves << std::endl;
+					}
+				}
+				continue;
+			}
+
+			PresentOverlayView<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const localOverlay(presentOverlay.getBase(), p.getPresentState());
+			bool const isNewRecord = currentMinPresentsLeft > localOverlay.getPresentsLeft();
+			bool const isPrinted = isNewRecord || (targetCounter % everyNthTarget == 0);
+			// Rebuilding the moves walks the predecessor log, so only do it if they are actually needed
+			std::string const moves = (isNewRecord || isPrinted || (localOverlay.getPresentsLeft() == 0)) ? penguinPositions.getMoves(index) : "";
+			if (isNewRecord) {
 				currentMinPresentsLeft = localOverlay.getPresentsLeft();
-				currentMinPresentsLeftMoves = p.getMoves();
-				isNewRecord = true;
+				currentMinPresentsLeftMoves = moves;
 			}
 			
-			if (isNewRecord || (targetCounter % everyNthTarget == 0)) {
+			if (isPrinted) {
 				auto const currentSearch = std::chrono::steady_clock::now();
 				auto const us = std::chrono::duration_cast<std::chrono::microseconds>(currentSearch - beginSearch).count();
 				double const speedTarget = static_cast<double>(us) / static_cast<double>(targetCounter);
 				double const speedRound = static_cast<double>(us) / static_cast<double>(roundCounter);
 
-				std::cout << "Found target #" << targetCounter << " with " << localOverlay.getPresentsLeft() << "/" << localOverlay.getBase().getTotalPresentCount() << " presents left using moves '" << p.getMoves() << "' - current best is " << currentMinPresentsLeft << "/" << localOverlay.getBase().getTotalPresentCount() << " with moves '" << currentMinPresentsLeftMoves << "', stack has " << penguinPositions.size() << " entries. ";
+				std::cout << "Found target #" << targetCounter << " with " << localOverlay.getPresentsLeft() << "/" << localOverlay.getBase().getTotalPresentCount() << " presents left using moves '" << moves << "' - current best is " << currentMinPresentsLeft << "/" << localOverlay.getBase().getTotalPresentCount() << " with moves '" << currentMinPresentsLeftMoves << "', stack has " << (penguinPositions.size() - index) << " entries. ";
 				std::cout << std::setprecision(6) << speedTarget << " us/T, " << std::setprecision(6) << speedRound << " us/R" << std::endl;
 			}
-			if ((!noBackups) && (isNewRecord || (targetCounter % everyNthTargetBackup == 0))) {
-				std::string const backupFilename = "state_" + std::to_string(targetCounter) + "_" + std::to_string(NUM_ROWS) + "_" + std::to_string(NUM_COLS) + "_" + std::to_string(IS_TORUS) + "_" + std::to_string(PRESENT_COUNT) + ".lz4.bin";
+			if ((!options.noBackups) && (isNewRecord || (targetCounter % everyNthTargetBackup == 0))) {
+				std::string const backupFilename = "state_" + std::to_string(targetCounter) + "_" + std::to_string(NUM_ROWS) + "_" + std::to_string(NUM_COLS) + "_" + std::to_string(IS_TORUS) + "_" + std::to_string(PRESENT_COUNT) + "_" + VISITED_SET::getName() + ".lz4.bin";
 				// In case we just restored from this backup
 				if (!ends_with(lastBackupFilename, backupFilename)) {
-					auto const beginBackup = std::chrono::steady_clock::now();
-					std::ofstream os(backupFilename, std::ios::binary);
-					lz4_stream::ostream compressedStream(os);
-					cereal::BinaryOutputArchive archive(compressedStream); // Create an output archive
-					archive(currentMinPresentsLeft, currentMinPresentsLeftMoves, targetCounter, roundCounter, penguinPositions, knownPositions);
-					auto const endBackup = std::chrono::steady_clock::now();
-					std::cout << "Made a state backup at #" << targetCounter << " in " << std::chrono::duration_cast<std::chrono::milliseconds>(endBackup - beginBackup).count() << " ms." << std::endl;
-					if (deleteOldBackups && !lastBackupFilename.empty()) {
-						if (std::filesystem::remove(lastBackupFilename)) {
-							std::cout << "Deleted last backup '" << lastBackupFilename << "'." << std::endl;
-						} else {
-							std::cerr << "Failed to delete last backup '" << lastBackupFilename << "'!" << std::endl;
-						}
-					}
-					lastBackupFilename = backupFilename;
+					// The current batch has not been expanded yet, so it is restarted as a whole when resuming
+					writeStateBackup(backupFilename, lastBackupFilename, options, STATE_BACKUP_TAG, STATE_BACKUP_VERSION, VISITED_SET::getName(), currentMinPresentsLeft, currentMinPresentsLeftMoves, targetCounter, roundCounter, penguinPositions, queueHead, queueDepth, levelEnd, bestSolutionLength, bestSolutionMoves, knownPositions);
 				}
 			}
 
 			++targetCounter;
 			
 			if (localOverlay.getPresentsLeft() == 0) {
-				std::cout << "Terminating search, found a solution collecting all presents: " << p.getMoves() << std::endl;
+				std::cout << "Terminating search, found a solution collecting all presents: " << moves << std::endl;
 				return roundCounter;
-			} else {
-				penguinPositions.pop();
-				continue;
 			}
 		}
 
-		if (board.template canMoveInDir<Direction::UP>(p.getPos(), target)) {
-			PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> localOverlay(presentOverlay.getBase(), p.getPresentState());
-			newPos = board.template moveInDir<Direction::UP>(p.getPos(), localOverlay);
-
-			updateStack(knownPositions, penguinPositions, p, localOverlay, newPos, 'U');
-		}
-		if (board.template canMoveInDir<Direction::DOWN>(p.getPos(), target)) {
-			PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> localOverlay(presentOverlay.getBase(), p.getPresentState());
-			newPos = board.template moveInDir<Direction::DOWN>(p.getPos(), localOverlay);
-			updateStack(knownPositions, penguinPositions, p, localOverlay, newPos, 'D');
-		}
-		if (board.template canMoveInDir<Direction::LEFT>(p.getPos(), target)) {
-			PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> localOverlay(presentOverlay.getBase(), p.getPresentState());
-			newPos = board.template moveInDir<Direction::LEFT>(p.getPos(), localOverlay);
-			updateStack(knownPositions, penguinPositions, p, localOverlay, newPos, 'L');
+		// Successors are only worth keeping if they can still lead to a shorter solution than the best one, this also drops all cells without a way to a target
+		std::size_t const childDepth = queueDepth + 1;
+		std::uint32_t const distanceLimit = (bestSolutionLength == std::numeric_limits<std::size_t>::max()) ? DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE : static_cast<std::uint32_t>((bestSolutionLength > childDepth) ? (bestSolutionLength - childDepth) : 0);
+		if (options.threadCount > 1) {
+			expandInParallel(board, oracle, presentDistances, endgame, distanceLimit, knownPositions, penguinPositions, queueHead, batchEnd, options.threadCount, candidates);
+		} else {
+			PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const p = penguinPositions.getState(queueHead);
+			if (!isFinishedByLookup(endgame, p.getPresentState())) {
+				for (auto it = board.getStopCellEdgesBegin(p.getPos()); it != board.getStopCellEdgesEnd(p.getPos()); ++it) {
+					if (getSuccessorLowerBound(oracle, presentDistances, endgame, p.getPresentState(), *it) < distanceLimit) {
+						updateStack(knownPositions, penguinPositions, queueHead, p, *it);
+					}
+				}
+			}
 		}
-		if (board.template canMoveInDir<Direction::RIGHT>(p.getPos(), target)) {
-			PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> localOverlay(presentOverlay.getBase(), p.getPresentState());
-			newPos = board.template moveInDir<Direction::RIGHT>(p.getPos(), localOverlay);
-			updateStack(knownPositions, penguinPositions, p, localOverlay, newPos, 'R');
+
+		queueHead = batchEnd;
+		penguinPositions.releaseStatesBefore(queueHead);
+		if (queueHead == levelEnd) {
+			++queueDepth;
+			levelEnd = penguinPositions.size();
 		}
+	}
 
-		penguinPositions.pop();
+	if (bestSolutionLength != std::numeric_limits<std::size_t>::max()) {
+		std::cout << "Terminating search, found a solution collecting all presents: " << bestSolutionMoves << std::endl;
+		return roundCounter;
 	}
 
 	std::cout << "Oh - no more states to explore - maybe there is no solution?" << std::endl;
@@ -0,0 +1,126 @@
+#ifndef PLAYASTAR_H_
+#define PLAYASTAR_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "AntichainSet.h"
+#include "Board.h"
+#include "BucketQueue.h"
+#include "DistanceOracle.h"
+#include "LayeredVisitedSet.h"
+#include "PlayWithHeuristic.h"
+#include "PredecessorLog.h"
+#include "SearchOptions.h"
+#include "StateBackup.h"
+
+#include "lz4_stream.h"
+
+/*
+	A* over the same states as play(), ordered by the moves so far plus the lower bound from HEURISTIC, see PresentDistances and PatternDatabase.
+	The lower bound has to be consistent, so the moves of a state are optimal once it is expanded and the first expanded state without presents left,
+	finished by the shortest way to a target, is an optimal solution.
+	States are pruned by the same per-cell subset check as in play(), which additionally has to compare depths here, see LayeredVisitedSet.
+	Returns the number of expanded states.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename HEURISTIC, typename VISITED_SET>
+std::size_t searchAStar(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const& presentOverlay, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, HEURISTIC const& heuristic, SearchOptions const& options) {
+	// Every discovered state and the number of moves it was reached with, the open list holds indices into both.
+	PredecessorLog<NUM_ROWS * NUM_COLS, PRESENT_COUNT> penguinPositions;
+	std::vector<std::uint32_t> depths;
+	BucketQueue<std::size_t> openList;
+	std::vector<LayeredVisitedSet<VISITED_SET>> knownPositions;
+
+	// No solution is shorter than the lowest priority in the open list
+	std::size_t lowerBound = 0;
+	std::size_t expandedCount = 0;
+	std::string lastBackupFilename = "";
+
+	if (!options.stateFilename.empty() && std::filesystem::exists(options.stateFilename)) {
+		auto const beginBackupLoad = std::chrono::steady_clock::now();
+
+		std::ifstream is(options.stateFilename, std::ios::binary);
+		lz4_stream::istream compressedStream(is);
+		cereal::BinaryInputArchive archive(compressedStream);
+		archive(lowerBound, expandedCount, penguinPositions, depths, openList, knownPositions);
+
+		auto const endBackupLoad = std::chrono::steady_clock::now();
+		std::cout << "Loaded state backup at lower bound " << lowerBound << " in " << std::chrono::duration_cast<std::chrono::milliseconds>(endBackupLoad - beginBackupLoad).count() << " ms, open list has " << openList.size() << " elements." << std::endl;
+		lastBackupFilename = options.stateFilename;
+	} else {
+		for (std::size_t i = 0; i < board.getStopCellCount(); ++i) {
+			knownPositions.push_back(LayeredVisitedSet<VISITED_SET>());
+		}
+
+		std::uint32_t const rootBound = heuristic.getLowerBound(board.getStartingStopCell(), presentOverlay.getRepresentation());
+		if (rootBound != HEURISTIC::UNREACHABLE) {
+			knownPositions[board.getStartingStopCell()].insertValueEvictingSupersets(presentOverlay.getRepresentation(), 0);
+			openList.push(rootBound, penguinPositions.addRoot(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(board.getStartingStopCell(), presentOverlay.getRepresentation())));
+			depths.push_back(0);
+		}
+	}
+
+	auto const beginSearch = std::chrono::steady_clock::now();
+	while (!openList.empty()) {
+		if (openList.getLowestPriority() > lowerBound) {
+			lowerBound = openList.getLowestPriority();
+
+			auto const currentSearch = std::chrono::steady_clock::now();
+			auto const us = std::chrono::duration_cast<std::chrono::microseconds>(currentSearch - beginSearch).count();
+			double const speedRound = static_cast<double>(us) / static_cast<double>(std::max<std::size_t>(expandedCount, 1));
+			std::cout << "Every solution needs at least " << lowerBound << " moves, expanded " << expandedCount << " states, open list has " << openList.size() << " entries. " << std::setprecision(6) << speedRound << " us/R" << std::endl;
+
+			if (!options.noBackups) {
+				std::string const backupFilename = "state_astar_" + std::to_string(lowerBound) + "_" + std::to_string(NUM_ROWS) + "_" + std::to_string(NUM_COLS) + "_" + std::to_string(IS_TORUS) + "_" + std::to_string(PRESENT_COUNT) + ".lz4.bin";
+				writeStateBackup(backupFilename, lastBackupFilename, options, lowerBound, expandedCount, penguinPositions, depths, openList, knownPositions);
+			}
+		}
+
+		std::size_t const index = openList.pop();
+		PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const p = penguinPositions.getState(index);
+		std::uint32_t const depth = depths[index];
+		// Dominated by a state reached after it was queued, in at most as many moves, which evicted it, so the other entry takes care of it
+		if (!knownPositions[p.getPos()].hasValue(p.getPresentState(), depth)) {
+			continue;
+		}
+		++expandedCount;
+
+		if (p.getPresentState().none()) {
+			std::string const moves = penguinPositions.getMoves(index) + oracle.getMovesToTarget(board, p.getPos());
+			std::cout << "Expanded " << expandedCount << " states." << std::endl;
+			std::cout << "Terminating search, found a solution collecting all presents: " << moves << std::endl;
+			return expandedCount;
+		}
+
+		std::uint32_t const childDepth = depth + 1;
+		for (auto it = board.getStopCellEdgesBegin(p.getPos()); it != board.getStopCellEdgesEnd(p.getPos()); ++it) {
+			std::bitset<PRESENT_COUNT> const presentState = p.getPresentState() & it->keepMask;
+			std::uint32_t const bound = heuristic.getLowerBound(it->target, presentState);
+			if ((bound == HEURISTIC::UNREACHABLE) || knownPositions[it->target].hasValueOrSubsetThereof(presentState, childDepth)) {
+				continue;
+			}
+			knownPositions[it->target].insertValueEvictingSupersets(presentState, childDepth);
+			openList.push(static_cast<std::size_t>(childDepth) + bound, penguinPositions.add(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(it->target, presentState), index, it->direction));
+			depths.push_back(childDepth);
+		}
+	}
+
+	std::cout << "Oh - no more states to explore - maybe there is no solution?" << std::endl;
+	return expandedCount;
+}
+
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename VISITED_SET = AntichainSet<PRESENT_COUNT>>
+std::size_t playAStar(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	return playWithHeuristic<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options, [&options](auto const& board, auto const& presentOverlay, auto const& oracle, auto const& heuristic) {
+		return searchAStar<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, std::decay_t<decltype(heuristic)>, VISITED_SET>(board, presentOverlay, oracle, heuristic, options);
+	});
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef PLAYBEAM_H_
+#define PLAYBEAM_H_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+#include "Board.h"
+#include "DistanceOracle.h"
+#include "PackedState.h"
+#include "PlayWithHeuristic.h"
+#include "PredecessorLog.h"
+#include "SearchOptions.h"
+
+template<std::size_t CELL_COUNT, std::size_t PRESENT_COUNT>
+struct BeamCandidate {
+public:
+	BeamCandidate(PackedState<CELL_COUNT, PRESENT_COUNT> const& state, std::uint32_t const& bound, std::size_t const& parentIndex, Direction const& direction) : state(state), presentsLeft(static_cast<std::uint32_t>(state.getPresentState().count())), bound(bound), parentIndex(parentIndex), direction(direction) {
+		//
+	}
+
+	// Fewer presents left first, then closer to finishing, the packed state only makes the order total.
+	inline bool operator<(BeamCandidate const& other) const {
+		return std::make_tuple(presentsLeft, bound, state.getValue()) < std::make_tuple(other.presentsLeft, other.bound, other.state.getValue());
+	}
+
+	PackedState<CELL_COUNT, PRESENT_COUNT> state;
+	std::uint32_t presentsLeft;
+	std::uint32_t bound;
+	std::size_t parentIndex;
+	Direction direction;
+};
+
+/*
+	Beam search for good solutions within seconds, without any guarantee of optimality.
+	Works level by level like play(), but only keeps the beamWidth best successors of every level, scored by the presents left
+	and then by the lower bound from HEURISTIC on the remaining moves. States seen on an earlier level are not taken again.
+	States without presents left are finished by the shortest way to a target right away and every improvement is printed as it is found.
+	Successors that can not beat the best solution so far are dropped, so the search ends once no state can improve on it.
+	Returns the number of expanded states.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename HEURISTIC>
+std::size_t searchBeam(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const& presentOverlay, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, HEURISTIC const& heuristic, SearchOptions const& options) {
+	std::size_t const beamWidth = std::max<std::size_t>(options.beamWidth, 1);
+	std::cout << "Beam width: " << beamWidth << std::endl;
+
+	// Every state that made it into a beam, the current beam is [levelBegin, size())
+	PredecessorLog<NUM_ROWS * NUM_COLS, PRESENT_COUNT> penguinPositions;
+	std::unordered_set<std::uint64_t> seenStates;
+	std::vector<BeamCandidate<NUM_ROWS * NUM_COLS, PRESENT_COUNT>> candidates;
+
+	std::size_t bestSolutionLength = std::numeric_limits<std::size_t>::max();
+	std::string bestSolutionMoves = "";
+	std::size_t targetCounter = 1;
+	std::size_t expandedCount = 0;
+
+	PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const root(board.getStartingStopCell(), presentOverlay.getRepresentation());
+	if (heuristic.getLowerBound(board.getStartingStopCell(), presentOverlay.getRepresentation()) == HEURISTIC::UNREACHABLE) {
+		std::cout << "Oh - no more states to explore - maybe there is no solution?" << std::endl;
+		return expandedCount;
+	}
+	penguinPositions.addRoot(root);
+	seenStates.insert(root.getValue());
+
+	auto const beginSearch = std::chrono::steady_clock::now();
+	std::size_t levelBegin = 0;
+	std::size_t depth = 0;
+	while (levelBegin < penguinPositions.size()) {
+		std::size_t const levelEnd = penguinPositions.size();
+		candidates.clear();
+		for (std::size_t index = levelBegin; index < levelEnd; ++index) {
+			++expandedCount;
+			PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const p = penguinPositions.getState(index);
+			if (p.getPresentState().none()) {
+				std::size_t const length = depth + oracle.getDistance(p.getPos());
+				if (length < bestSolutionLength) {
+					bestSolutionLength = length;
+					bestSolutionMoves = penguinPositions.getMoves(index) + oracle.getMovesToTarget(board, p.getPos());
+
+					auto const us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - beginSearch).count();
+					std::cout << "Found target #" << targetCounter << " with 0/" << presentOverlay.getBase().getTotalPresentCount() << " presents left using moves '" << bestSolutionMoves << "' - current best is " << bestSolutionLength << " moves, beam has " << (levelEnd - levelBegin) << " entries. " << std::setprecision(6) << (static_cast<double>(us) / 1000.0) << " ms" << std::endl;
+					++targetCounter;
+				}
+				continue;
+			}
+
+			for (auto it = board.getStopCellEdgesBegin(p.getPos()); it != board.getStopCellEdgesEnd(p.getPos()); ++it) {
+				std::bitset<PRESENT_COUNT> const presentState = p.getPresentState() & it->keepMask;
+				std::uint32_t const bound = heuristic.getLowerBound(it->target, presentState);
+				if ((bound == HEURISTIC::UNREACHABLE) || (depth + 1 + bound >= bestSolutionLength)) {
+					continue;
+				}
+				PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const child(it->target, presentState);
+				if (seenStates.count(child.getValue()) == 0) {
+					candidates.push_back(BeamCandidate<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(child, bound, index, it->direction));
+				}
+			}
+		}
+
+		// Keep the best beamWidth distinct successors, in order, so the result does not depend on the order of expansion
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end(), [](BeamCandidate<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const& a, BeamCandidate<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const& b) { return a.state.getValue() == b.state.getValue(); }), candidates.end());
+		if (candidates.size() > beamWidth) {
+			candidates.erase(candidates.begin() + beamWidth, candidates.end());
+		}
+		for (auto it = candidates.cbegin(); it != candidates.cend(); ++it) {
+			seenStates.insert(it->state.getValue());
+			penguinPositions.add(it->state, it->parentIndex, it->direction);
+		}
+
+		levelBegin = levelEnd;
+		penguinPositions.releaseStatesBefore(levelBegin);
+		++depth;
+	}
+
+	if (bestSolutionLength != std::numeric_limits<std::size_t>::max()) {
+		std::cout << "Terminating search, found a solution collecting all presents: " << bestSolutionMoves << std::endl;
+		return expandedCount;
+	}
+
+	std::cout << "Oh - no more states to explore - maybe there is no solution?" << std::endl;
+	return expandedCount;
+}
+
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t playBeam(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	return playWithHeuristic<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options, [&options](auto const& board, auto const& presentOverlay, auto const& oracle, auto const& heuristic) {
+		return searchBeam(board, presentOverlay, oracle, heuristic, options);
+	});
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef PLAYBIDIRECTIONAL_H_
+#define PLAYBIDIRECTIONAL_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Board.h"
+#include "BoardPiece.h"
+#include "PresentOverlay.h"
+#include "SearchOptions.h"
+
+/*
+	What one side of the bidirectional search knows about a cell: its distance and the neighbouring cell on the way, the parent for the forward side and the successor for the backward side.
+*/
+struct BidirectionalVisit {
+public:
+	BidirectionalVisit(std::uint32_t const& distance, std::size_t const& link, Direction const& direction) : distance(distance), link(link), direction(direction) {
+		//
+	}
+
+	std::uint32_t distance;
+	std::size_t link;
+	// The slide between the cell and link.
+	Direction direction;
+};
+
+/*
+	Shortest way to a target for boards without presents, by a BFS from the start meeting a BFS backwards from all targets.
+	Always the side with the smaller frontier is expanded by one full level. Once the two sides meet, the shortest connection over
+	all meeting points of that level is optimal, as both sides have completely explored every distance up to their current level.
+	The board is built without its slide graph, which would already be a full search over all stop cells: both sides walk the grid for the cells they expand,
+	the backward side over every cell the penguin may rest on, see Board::forEachSlideInto(), and only these cells are remembered.
+	Returns the number of cells that were expanded.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t playBidirectional(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& /*options*/) {
+	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections, false);
+	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board = init.first;
+	if (init.second.getPresentsLeft() > 0) {
+		std::cerr << "The bidirectional search only supports boards without presents!" << std::endl;
+		exit(-1);
+	}
+
+	std::size_t const noCell = std::numeric_limits<std::size_t>::max();
+	std::unordered_map<std::size_t, BidirectionalVisit> forward;
+	std::unordered_map<std::size_t, BidirectionalVisit> backward;
+
+	std::vector<std::size_t> forwardFrontier;
+	std::vector<std::size_t> backwardFrontier;
+	std::vector<std::size_t> nextFrontier;
+
+	std::size_t const start = board.getPenguinStartingPosition();
+	forward.emplace(start, BidirectionalVisit(0, start, Direction::UP));
+	forwardFrontier.push_back(start);
+	for (std::size_t pos = 0; pos < NUM_ROWS * NUM_COLS; ++pos) {
+		if (board.getPieceAt(pos) == BoardPiece::TARGET) {
+			backward.emplace(pos, BidirectionalVisit(0, pos, Direction::UP));
+			backwardFrontier.push_back(pos);
+		}
+	}
+
+	std::size_t meetingPoint = (backward.count(start) > 0) ? start : noCell;
+	std::uint64_t bestLength = (meetingPoint != noCell) ? 0 : std::numeric_limits<std::uint64_t>::max();
+	// Remembers pos as seen by one side and checks whether the other side already knows it
+	auto const visit = [&](std::unordered_map<std::size_t, BidirectionalVisit>& side, std::unordered_map<std::size_t, BidirectionalVisit> const& other, std::size_t const& pos, BidirectionalVisit const& seen) {
+		if (!side.emplace(pos, seen).second) {
+			return;
+		}
+		nextFrontier.push_back(pos);
+		auto const it = other.find(pos);
+		if ((it != other.cend()) && (static_cast<std::uint64_t>(seen.distance) + it->second.distance < bestLength)) {
+			bestLength = static_cast<std::uint64_t>(seen.distance) + it->second.distance;
+			meetingPoint = pos;
+		}
+	};
+
+	std::size_t expandedCount = 0;
+	while ((meetingPoint == noCell) && !forwardFrontier.empty() && !backwardFrontier.empty()) {
+		nextFrontier.clear();
+		if (forwardFrontier.size() <= backwardFrontier.size()) {
+			for (auto itC = forwardFrontier.cbegin(); itC != forwardFrontier.cend(); ++itC) {
+				std::uint32_t const distance = forward.at(*itC).distance + 1;
+				auto const slide = [&](std::size_t const& target, Direction const& direction) {
+					if (target != SlideTransition<PRESENT_COUNT>::INVALID_POSITION) {
+						visit(forward, backward, target, BidirectionalVisit(distance, *itC, direction));
+					}
+				};
+				PresentOverlayView<NUM_ROWS, NUM_COLS, PRESENT_COUNT> presents = init.second.getView();
+				slide(board.template getSlideTarget<Direction::UP>(*itC, presents), Direction::UP);
+				slide(board.template getSlideTarget<Direction::DOWN>(*itC, presents), Direction::DOWN);
+				slide(board.template getSlideTarget<Direction::LEFT>(*itC, presents), Direction::LEFT);
+				slide(board.template getSlideTarget<Direction::RIGHT>(*itC, presents), Direction::RIGHT);
+			}
+			expandedCount += forwardFrontier.size();
+			forwardFrontier.swap(nextFrontier);
+		} else {
+			for (auto itC = backwardFrontier.cbegin(); itC != backwardFrontier.cend(); ++itC) {
+				std::uint32_t const distance = backward.at(*itC).distance + 1;
+				board.forEachSlideInto(*itC, [&](std::size_t const& origin, Direction const& direction) {
+					visit(backward, forward, origin, BidirectionalVisit(distance, *itC, direction));
+				});
+			}
+			expandedCount += backwardFrontier.size();
+			backwardFrontier.swap(nextFrontier);
+		}
+	}
+
+	if (meetingPoint == noCell) {
+		std::cout << "Oh - no more states to explore - maybe there is no solution?" << std::endl;
+		return expandedCount;
+	}
+
+	std::string moves;
+	for (std::size_t pos = meetingPoint; pos != start; pos = forward.at(pos).link) {
+		moves.push_back(directionToChar(forward.at(pos).direction));
+	}
+	std::reverse(moves.begin(), moves.end());
+	for (std::size_t pos = meetingPoint; backward.at(pos).distance > 0; pos = backward.at(pos).link) {
+		moves.push_back(directionToChar(backward.at(pos).direction));
+	}
+
+	std::cout << "Met after expanding " << expandedCount << " cells, having seen " << (forward.size() + backward.size()) << " of " << (NUM_ROWS * NUM_COLS) << "." << std::endl;
+	std::cout << "Terminating search, found a solution collecting all presents: " << moves << std::endl;
+	return expandedCount;
+}
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef PLAYBRANCHANDBOUND_H_
+#define PLAYBRANCHANDBOUND_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Board.h"
+#include "ConcurrentDepthTable.h"
+#include "DistanceOracle.h"
+#include "PackedState.h"
+#include "Parallel.h"
+#include "PlayWithHeuristic.h"
+#include "SearchOptions.h"
+#include "WorkStealingDeque.h"
+
+/*
+	Depth-first branch and bound on all threads, for the shortest solution with at most maxMoves moves, if given.
+	A state is cut off once its moves so far plus the lower bound from HEURISTIC can not beat the best solution found so far,
+	which all threads share through an atomic, and once it has already been entered with at most as many moves, see ConcurrentDepthTable.
+	Every thread owns a WorkStealingDeque of subtrees. It searches depth-first on its own, always descending into the most promising successor itself,
+	and only offers the least promising other successor of a state as a subtree while its deque is empty, so work is only split where other threads
+	can take it. Idle threads steal the oldest, i.e. shallowest and largest, subtree of a random other thread.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename HEURISTIC>
+class BranchAndBoundSearch {
+public:
+	static constexpr std::uint32_t UNREACHABLE = HEURISTIC::UNREACHABLE;
+	static_assert(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>::TOTAL_BITS <= ConcurrentDepthTable::KEY_BITS, "Packed states do not fit into the keys of the depth table.");
+
+	BranchAndBoundSearch(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, HEURISTIC const& heuristic, std::uint64_t const& tableByteCount, std::size_t const& threadCount) : m_board(board), m_oracle(oracle), m_heuristic(heuristic), m_table(tableByteCount), m_deques(), m_pendingTaskCount(0), m_bestLength(UNREACHABLE), m_solutionMutex(), m_solution(""), m_expandedCounts(threadCount) {
+		for (std::size_t i = 0; i < threadCount; ++i) {
+			m_deques.push_back(std::make_unique<WorkStealingDeque<Task*>>(DEQUE_CAPACITY_BITS));
+		}
+	}
+	~BranchAndBoundSearch() {
+		//
+	}
+
+	/*
+		Searches for solutions shorter than lengthLimit, UNREACHABLE for no limit.
+		Returns the length of the shortest one, UNREACHABLE if there is none.
+	*/
+	std::uint32_t search(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState, std::uint32_t const& lengthLimit) {
+		m_bestLength.store(lengthLimit);
+		std::uint32_t const bound = m_heuristic.getLowerBound(stopCell, presentState);
+		if ((bound == UNREACHABLE) || (bound >= lengthLimit)) {
+			return UNREACHABLE;
+		}
+		m_table.tryEnter(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(stopCell, presentState).getValue(), 0);
+		m_pendingTaskCount.store(1);
+		m_deques[0]->push(new Task{ static_cast<std::uint32_t>(stopCell), 0, presentState, "" });
+
+		runOnThreads(m_deques.size(), [this](std::size_t threadIndex) { work(threadIndex); });
+
+		std::uint32_t const result = m_bestLength.load();
+		return (result < lengthLimit) ? result : UNREACHABLE;
+	}
+
+	std::string const& getSolution() const {
+		return m_solution;
+	}
+
+	std::size_t getExpandedCount() const {
+		std::size_t result = 0;
+		for (auto it = m_expandedCounts.cbegin(); it != m_expandedCounts.cend(); ++it) {
+			result += it->value;
+		}
+		return result;
+	}
+private:
+	static constexpr std::size_t DEQUE_CAPACITY_BITS = 12;
+
+	struct Task {
+		std::uint32_t stopCell;
+		std::uint32_t depth;
+		std::bitset<PRESENT_COUNT> presentState;
+		std::string moves;
+	};
+
+	// One per thread, on its own cache line
+	struct alignas(64) Counter {
+		std::size_t value = 0;
+	};
+
+	struct Child {
+		std::uint32_t bound;
+		std::uint32_t target;
+		Direction direction;
+		std::bitset<PRESENT_COUNT> presentState;
+	};
+
+	void work(std::size_t const& threadIndex) {
+		std::minstd_rand random(static_cast<std::uint32_t>(threadIndex + 1));
+		WorkStealingDeque<Task*>& deque = *m_deques[threadIndex];
+		std::string moves;
+		std::size_t failedSteals = 0;
+		while (m_pendingTaskCount.load(std::memory_order_acquire) > 0) {
+			Task* task = deque.pop();
+			if ((task == nullptr) && (m_deques.size() > 1)) {
+				std::size_t const victim = (threadIndex + 1 + (random() % (m_deques.size() - 1))) % m_deques.size();
+				task = m_deques[victim]->steal();
+			}
+			if (task == nullptr) {
+				if (++failedSteals > 64) {
+					std::this_thread::yield();
+				}
+				continue;
+			}
+			failedSteals = 0;
+
+			moves = task->moves;
+			explore(threadIndex, task->stopCell, task->presentState, task->depth, moves);
+			delete task;
+			m_pendingTaskCount.fetch_sub(1, std::memory_order_release);
+		}
+	}
+
+	void explore(std::size_t const& threadIndex, std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState, std::uint32_t const& depth, std::string& moves) {
+		++m_expandedCounts[threadIndex].value;
+		if (presentState.none()) {
+			// The oracle gives the exact remaining distance, which was part of the bound that let this state in
+			std::uint32_t const length = depth + m_oracle.getDistance(stopCell);
+			std::lock_guard<std::mutex> lock(m_solutionMutex);
+			if (length < m_bestLength.load()) {
+				m_solution = moves + m_oracle.getMovesToTarget(m_board, stopCell);
+				m_bestLength.store(length);
+				std::cout << "Found a solution with " << length << " moves: " << m_solution << std::endl;
+			}
+			return;
+		}
+		if (depth + 1 >= ConcurrentDepthTable::MAX_DEPTH) {
+			return;
+		}
+
+		// The most promising successors first, so good solutions are found early and prune the rest
+		std::array<Child, DIRECTION_COUNT> children;
+		std::size_t childCount = 0;
+		for (auto it = m_board.getStopCellEdgesBegin(stopCell); it != m_board.getStopCellEdgesEnd(stopCell); ++it) {
+			std::bitset<PRESENT_COUNT> const childState = presentState & it->keepMask;
+			std::uint32_t const bound = m_heuristic.getLowerBound(it->target, childState);
+			if ((bound != UNREACHABLE) && (depth + 1 + bound < m_bestLength.load(std::memory_order_relaxed))) {
+				children[childCount++] = Child{ bound, it->target, it->direction, childState };
+			}
+		}
+		std::stable_sort(children.begin(), children.begin() + childCount, [](Child const& a, Child const& b) { return a.bound < b.bound; });
+
+		WorkStealingDeque<Task*> const& deque = *m_deques[threadIndex];
+		for (std::size_t i = 0; i < childCount; ++i) {
+			Child const& child = children[i];
+			// The best solution might have improved in the meantime
+			if (depth + 1 + child.bound >= m_bestLength.load(std::memory_order_relaxed)) {
+				break;
+			}
+			if (!m_table.tryEnter(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(child.target, child.presentState).getValue(), depth + 1)) {
+				continue;
+			}
+			// This thread goes on with the most promising successor, an idle thread can take the worst one
+			if ((i + 1 < childCount) && (m_deques.size() > 1) && deque.empty()) {
+				--childCount;
+				offerChild(threadIndex, children[childCount], depth, moves);
+			}
+			moves.push_back(directionToChar(child.direction));
+			explore(threadIndex, child.target, child.presentState, depth + 1, moves);
+			moves.pop_back();
+		}
+	}
+
+	// Pushes the child as a subtree, or explores it right away if it does not fit into the deque.
+	void offerChild(std::size_t const& threadIndex, Child const& child, std::uint32_t const& depth, std::string& moves) {
+		if (depth + 1 + child.bound >= m_bestLength.load(std::memory_order_relaxed)) {
+			return;
+		}
+		if (!m_table.tryEnter(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(child.target, child.presentState).getValue(), depth + 1)) {
+			return;
+		}
+		moves.push_back(directionToChar(child.direction));
+		Task* const task = new Task{ child.target, depth + 1, child.presentState, moves };
+		m_pendingTaskCount.fetch_add(1, std::memory_order_relaxed);
+		if (!m_deques[threadIndex]->push(task)) {
+			m_pendingTaskCount.fetch_sub(1, std::memory_order_relaxed);
+			delete task;
+			explore(threadIndex, child.target, child.presentState, depth + 1, moves);
+		}
+		moves.pop_back();
+	}
+
+	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& m_board;
+	DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& m_oracle;
+	HEURISTIC const& m_heuristic;
+	ConcurrentDepthTable m_table;
+	std::vector<std::unique_ptr<WorkStealingDeque<Task*>>> m_deques;
+	// Tasks in any deque or being explored, the search is done once this drops to zero
+	std::atomic<std::size_t> m_pendingTaskCount;
+	std::atomic<std::uint32_t> m_bestLength;
+	std::mutex m_solutionMutex;
+	std::string m_solution;
+	std::vector<Counter> m_expandedCounts;
+};
+
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename HEURISTIC>
+std::size_t searchBranchAndBound(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const& presentOverlay, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, HEURISTIC const& heuristic, SearchOptions const& options) {
+	BranchAndBoundSearch<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, HEURISTIC> search(board, oracle, heuristic, options.transpositionTableMemory, options.threadCount);
+	std::uint32_t const lengthLimit = (options.maxMoves > 0) ? static_cast<std::uint32_t>(options.maxMoves + 1) : BranchAndBoundSearch<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, HEURISTIC>::UNREACHABLE;
+
+	auto const beginSearch = std::chrono::steady_clock::now();
+	std::uint32_t const length = search.search(board.getStartingStopCell(), presentOverlay.getRepresentation(), lengthLimit);
+	auto const endSearch = std::chrono::steady_clock::now();
+	std::cout << "Expanded " << search.getExpandedCount() << " states in " << std::chrono::duration_cast<std::chrono::milliseconds>(endSearch - beginSearch).count() << " ms." << std::endl;
+
+	if (length != BranchAndBoundSearch<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, HEURISTIC>::UNREACHABLE) {
+		std::cout << "Terminating search, found a solution collecting all presents: " << search.getSolution() << std::endl;
+	} else if (options.maxMoves > 0) {
+		std::cout << "There is no solution with at most " << options.maxMoves << " moves." << std::endl;
+	} else {
+		std::cout << "Oh - no more states to explore - maybe there is no solution?" << std::endl;
+	}
+	return search.getExpandedCount();
+}
+
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t playBranchAndBound(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	return playWithHeuristic<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options, [&options](auto const& board, auto const& presentOverlay, auto const& oracle, auto const& heuristic) {
+		return searchBranchAndBound(board, presentOverlay, oracle, heuristic, options);
+	});
+}
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef PLAYIDASTAR_H_
+#define PLAYIDASTAR_H_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "DistanceOracle.h"
+#include "PackedState.h"
+#include "PlayWithHeuristic.h"
+#include "SearchOptions.h"
+#include "StateBackup.h"
+#include "TranspositionTable.h"
+
+#include "lz4_stream.h"
+
+/*
+	Iterative deepening A*: repeated depth-first searches, each bounded by a threshold on the moves so far plus the lower bound from HEURISTIC,
+	starting with the lower bound of the starting state and raised to the smallest value that exceeded it after every unsuccessful iteration.
+	As the lower bound is admissible, the first solution found is optimal.
+	Apart from the current path, the only memory is the TranspositionTable: a state that was searched without success learns that it needs
+	more moves than its budget allowed, which prunes it when it is reached again, in the same iteration or a later one.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename HEURISTIC>
+class IdaStarSearch {
+public:
+	static constexpr std::uint32_t UNREACHABLE = HEURISTIC::UNREACHABLE;
+
+	IdaStarSearch(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, HEURISTIC const& heuristic, std::uint64_t const& tableByteCount) : m_board(board), m_oracle(oracle), m_heuristic(heuristic), m_table(tableByteCount), m_path(), m_threshold(0), m_isSolved(false), m_solution(""), m_expandedCount(0) {
+		//
+	}
+	~IdaStarSearch() {
+		//
+	}
+
+	/*
+		Searches all ways within the threshold from the given state.
+		Returns the threshold if a solution was found, the smallest f-value beyond the threshold otherwise, UNREACHABLE if there is none.
+	*/
+	std::uint32_t searchIteration(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState, std::uint32_t const& threshold) {
+		m_threshold = threshold;
+		m_path.clear();
+		return search(stopCell, presentState, 0);
+	}
+
+	std::uint32_t getLowerBound(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		std::uint32_t const bound = m_heuristic.getLowerBound(stopCell, presentState);
+		if (bound == UNREACHABLE) {
+			return UNREACHABLE;
+		}
+		return std::max(bound, m_table.getBound(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(stopCell, presentState).getValue()));
+	}
+
+	bool isSolved() const {
+		return m_isSolved;
+	}
+
+	std::string const& getSolution() const {
+		return m_solution;
+	}
+
+	std::size_t getExpandedCount() const {
+		return m_expandedCount;
+	}
+
+	TranspositionTable const& getTable() const {
+		return m_table;
+	}
+private:
+	struct Child {
+		std::uint32_t bound;
+		std::uint32_t target;
+		Direction direction;
+		std::bitset<PRESENT_COUNT> presentState;
+	};
+
+	std::uint32_t search(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState, std::uint32_t const& depth) {
+		++m_expandedCount;
+		if (presentState.none()) {
+			// Only searched if it fits the threshold, and the oracle gives the exact remaining distance
+			m_isSolved = true;
+			m_solution = std::string(m_path.cbegin(), m_path.cend()) + m_oracle.getMovesToTarget(m_board, stopCell);
+			return m_threshold;
+		}
+
+		// The most promising successors first, so the last iteration finds the solution early
+		std::array<Child, DIRECTION_COUNT> children;
+		std::size_t childCount = 0;
+		for (auto it = m_board.getStopCellEdgesBegin(stopCell); it != m_board.getStopCellEdgesEnd(stopCell); ++it) {
+			std::bitset<PRESENT_COUNT> const childState = presentState & it->keepMask;
+			std::uint32_t const bound = getLowerBound(it->target, childState);
+			if (bound != UNREACHABLE) {
+				children[childCount++] = Child{ bound, it->target, it->direction, childState };
+			}
+		}
+		std::stable_sort(children.begin(), children.begin() + childCount, [](Child const& a, Child const& b) { return a.bound < b.bound; });
+
+		std::uint32_t result = UNREACHABLE;
+		for (std::size_t i = 0; i < childCount; ++i) {
+			std::uint32_t const f = depth + 1 + children[i].bound;
+			if (f > m_threshold) {
+				result = std::min(result, f);
+				// Sorted by bound, so all following ones exceed the threshold as well
+				break;
+			}
+			m_path.push_back(directionToChar(children[i].direction));
+			std::uint32_t const childResult = search(children[i].target, children[i].presentState, depth + 1);
+			m_path.pop_back();
+			if (m_isSolved) {
+				return m_threshold;
+			}
+			result = std::min(result, childResult);
+		}
+
+		if (result != UNREACHABLE) {
+			m_table.storeBound(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(stopCell, presentState).getValue(), result - depth);
+		}
+		return result;
+	}
+
+	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& m_board;
+	DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& m_oracle;
+	HEURISTIC const& m_heuristic;
+	TranspositionTable m_table;
+	std::vector<char> m_path;
+	std::uint32_t m_threshold;
+	bool m_isSolved;
+	std::string m_solution;
+	std::size_t m_expandedCount;
+};
+
+/*
+	Runs IdaStarSearch with thresholds increasing until a solution is found.
+	After every iteration, the threshold is written to a small backup, as it is a valid starting point for a restart.
+	Returns the number of expanded states.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename HEURISTIC>
+std::size_t searchIdaStar(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const& presentOverlay, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, HEURISTIC const& heuristic, SearchOptions const& options) {
+	IdaStarSearch<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, HEURISTIC> search(board, oracle, heuristic, options.transpositionTableMemory);
+	std::cout << "Transposition table: " << search.getTable().getCapacity() << " entries, " << (options.transpositionTableMemory / (1024 * 1024)) << " MiB at most" << std::endl;
+
+	std::size_t const startingStopCell = board.getStartingStopCell();
+	std::bitset<PRESENT_COUNT> const startingState = presentOverlay.getRepresentation();
+	std::uint32_t threshold = search.getLowerBound(startingStopCell, startingState);
+	std::size_t previousExpandedCount = 0;
+	std::string lastBackupFilename = "";
+
+	if (!options.stateFilename.empty() && std::filesystem::exists(options.stateFilename)) {
+		std::ifstream is(options.stateFilename, std::ios::binary);
+		lz4_stream::istream compressedStream(is);
+		cereal::BinaryInputArchive archive(compressedStream);
+		std::uint32_t loadedThreshold = 0;
+		archive(loadedThreshold, previousExpandedCount);
+		threshold = std::max(threshold, loadedThreshold);
+		std::cout << "Loaded state backup, continuing with threshold " << threshold << "." << std::endl;
+		lastBackupFilename = options.stateFilename;
+	}
+
+	auto const beginSearch = std::chrono::steady_clock::now();
+	while (threshold != IdaStarSearch<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, HEURISTIC>::UNREACHABLE) {
+		auto const beginIteration = std::chrono::steady_clock::now();
+		std::uint32_t const nextThreshold = search.searchIteration(startingStopCell, startingState, threshold);
+		auto const endIteration = std::chrono::steady_clock::now();
+		std::size_t const expandedCount = previousExpandedCount + search.getExpandedCount();
+		std::cout << "Threshold " << threshold << " done in " << std::chrono::duration_cast<std::chrono::milliseconds>(endIteration - beginIteration).count() << " ms, expanded " << expandedCount << " states in total, transposition table holds " << search.getTable().getEntryCount() << " entries." << std::endl;
+
+		if (search.isSolved()) {
+			auto const us = std::chrono::duration_cast<std::chrono::microseconds>(endIteration - beginSearch).count();
+			std::cout << "Expanded " << expandedCount << " states in " << us << " us." << std::endl;
+			std::cout << "Terminating search, found a solution collecting all presents: " << search.getSolution() << std::endl;
+			return expandedCount;
+		}
+		threshold = nextThreshold;
+
+		if ((!options.noBackups) && (threshold != IdaStarSearch<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, HEURISTIC>::UNREACHABLE)) {
+			std::string const backupFilename = "state_idastar_" + std::to_string(threshold) + "_" + std::to_string(NUM_ROWS) + "_" + std::to_string(NUM_COLS) + "_" + std::to_string(IS_TORUS) + "_" + std::to_string(PRESENT_COUNT) + ".lz4.bin";
+			writeStateBackup(backupFilename, lastBackupFilename, options, threshold, expandedCount);
+		}
+	}
+
+	std::cout << "Oh - no more states to explore - maybe there is no solution?" << std::endl;
+	return previousExpandedCount + search.getExpandedCount();
+}
+
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t playIdaStar(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	return playWithHeuristic<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options, [&options](auto const& board, auto const& presentOverlay, auto const& oracle, auto const& heuristic) {
+		return searchIdaStar(board, presentOverlay, oracle, heuristic, options);
+	});
+}
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef PLAYMEETINTHEMIDDLE_H_
+#define PLAYMEETINTHEMIDDLE_H_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AntichainSet.h"
+#include "Board.h"
+#include "PackedState.h"
+#include "PredecessorLog.h"
+#include "SearchOptions.h"
+#include "SubsetClosure.h"
+
+/*
+	One direction of the meet-in-the-middle search: every state found so far in BFS order, the states of the last level are [levelBegin, size()) of the log.
+	Forward, the present state of a cell is the set of presents still on the board after the moves from the start.
+	Backward, it is the set of presents not collected by the moves from the cell to a target. Both only get better by getting smaller,
+	so both sides keep the same antichains of minimal present states per cell as play().
+*/
+template<std::size_t CELL_COUNT, std::size_t PRESENT_COUNT>
+struct MeetInTheMiddleSide {
+public:
+	explicit MeetInTheMiddleSide(std::size_t const& stopCellCount) : penguinPositions(), knownPositions(stopCellCount), levelBegin(0), depth(0) {
+		//
+	}
+
+	inline std::size_t getLevelSize() const {
+		return penguinPositions.size() - levelBegin;
+	}
+
+	PredecessorLog<CELL_COUNT, PRESENT_COUNT> penguinPositions;
+	std::vector<AntichainSet<PRESENT_COUNT>> knownPositions;
+	std::size_t levelBegin;
+	std::size_t depth;
+};
+
+// Beyond this, the SubsetClosure needs more than 2 MiB and its transform outweighs the scans.
+static constexpr std::size_t MAX_CLOSURE_BIT_COUNT = 24;
+
+/*
+	Looks for a state of the last level of side that meets a state of other, i.e. the two are on the same cell and their present states are disjoint:
+	every present left by one way is collected by the other. That holds if other knows a subset of the complement of the present state of side.
+	The last level is grouped by cell, and the family of other on a cell is turned into a SubsetClosure if it is queried often enough to pay for it.
+	On success, returns true and the indices of both states in their logs.
+*/
+template<std::size_t CELL_COUNT, std::size_t PRESENT_COUNT>
+bool findMeetingStates(MeetInTheMiddleSide<CELL_COUNT, PRESENT_COUNT> const& side, MeetInTheMiddleSide<CELL_COUNT, PRESENT_COUNT> const& other, SubsetClosure<std::min<std::size_t>(PRESENT_COUNT, MAX_CLOSURE_BIT_COUNT)>& closure, std::size_t& sideIndex, std::size_t& otherIndex) {
+	std::vector<std::pair<std::uint32_t, std::size_t>> level;
+	level.reserve(side.getLevelSize());
+	for (std::size_t index = side.levelBegin; index < side.penguinPositions.size(); ++index) {
+		level.push_back(std::make_pair(static_cast<std::uint32_t>(side.penguinPositions.getState(index).getPos()), index));
+	}
+	std::sort(level.begin(), level.end());
+
+	// The word operations of building a closure, against the masks one scan checks per word operation
+	std::uint64_t const closureCost = ((std::uint64_t(1) << PRESENT_COUNT) / 64 + 1) * (PRESENT_COUNT + 1) * 8;
+	for (std::size_t groupBegin = 0; groupBegin < level.size();) {
+		std::uint32_t const stopCell = level[groupBegin].first;
+		std::size_t groupEnd = groupBegin;
+		while ((groupEnd < level.size()) && (level[groupEnd].first == stopCell)) {
+			++groupEnd;
+		}
+		AntichainSet<PRESENT_COUNT> const& family = other.knownPositions[stopCell];
+		std::size_t const familySize = family.size();
+
+		bool useClosure = false;
+		if constexpr (PRESENT_COUNT <= MAX_CLOSURE_BIT_COUNT) {
+			useClosure = (static_cast<std::uint64_t>(groupEnd - groupBegin) * familySize) > closureCost;
+			if (useClosure) {
+				closure.clear();
+				family.forEachValue([&closure](std::uint32_t const& bits) { closure.insertValue(bits); });
+				closure.close();
+			}
+		}
+
+		for (std::size_t i = groupBegin; (i < groupEnd) && (familySize > 0); ++i) {
+			std::bitset<PRESENT_COUNT> const presentState = side.penguinPositions.getState(level[i].second).getPresentState();
+			std::bitset<PRESENT_COUNT> const complement = ~presentState;
+			bool const isMeeting = useClosure ? closure.hasValueOrSubsetThereof(complement.to_ullong()) : family.hasValueOrSubsetThereof(complement);
+			if (!isMeeting) {
+				continue;
+			}
+			// Found once, so a linear scan for the partner is fine
+			for (std::size_t index = 0; index < other.penguinPositions.size(); ++index) {
+				PackedState<CELL_COUNT, PRESENT_COUNT> const& p = other.penguinPositions.getState(index);
+				if ((p.getPos() == stopCell) && (p.getPresentState() & presentState).none()) {
+					sideIndex = level[i].second;
+					otherIndex = index;
+					return true;
+				}
+			}
+		}
+		groupBegin = groupEnd;
+	}
+	return false;
+}
+
+/*
+	Meet-in-the-middle: a BFS forward from the start and one backward from all targets, always extending the side with the smaller last level by one move.
+	After every level, its new states are joined with all states of the other side, see findMeetingStates().
+	As every total number of moves is checked before the next one, the first meeting gives a shortest solution, and each side only has to reach about half its length.
+	Stops without a solution once both sides run out of states, or once the total reaches maxMoves, if given.
+	Returns the number of expanded states.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t playMeetInTheMiddle(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections);
+	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board = init.first;
+	std::bitset<PRESENT_COUNT> const allPresents = init.second.getRepresentation();
+	std::size_t const stopCellCount = board.getStopCellCount();
+
+	MeetInTheMiddleSide<NUM_ROWS * NUM_COLS, PRESENT_COUNT> forward(stopCellCount);
+	MeetInTheMiddleSide<NUM_ROWS * NUM_COLS, PRESENT_COUNT> backward(stopCellCount);
+	SubsetClosure<std::min<std::size_t>(PRESENT_COUNT, MAX_CLOSURE_BIT_COUNT)> closure;
+
+	forward.knownPositions[board.getStartingStopCell()].insertValue(allPresents);
+	forward.penguinPositions.addRoot(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(board.getStartingStopCell(), allPresents));
+	for (std::size_t stopCell = 0; stopCell < stopCellCount; ++stopCell) {
+		if (board.isTargetStopCell(stopCell)) {
+			backward.knownPositions[stopCell].insertValue(allPresents);
+			backward.penguinPositions.addRoot(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(stopCell, allPresents));
+		}
+	}
+
+	auto const beginSearch = std::chrono::steady_clock::now();
+	std::size_t expandedCount = 0;
+	std::size_t forwardIndex = 0;
+	std::size_t backwardIndex = 0;
+	bool isMet = findMeetingStates(forward, backward, closure, forwardIndex, backwardIndex);
+	while (!isMet && ((forward.getLevelSize() > 0) || (backward.getLevelSize() > 0)) && ((options.maxMoves == 0) || (forward.depth + backward.depth < options.maxMoves))) {
+		// Once a side knows all its states, only the other one can still find new meetings
+		bool const isForward = (backward.getLevelSize() == 0) || ((forward.getLevelSize() > 0) && (forward.getLevelSize() <= backward.getLevelSize()));
+		MeetInTheMiddleSide<NUM_ROWS * NUM_COLS, PRESENT_COUNT>& side = isForward ? forward : backward;
+		std::size_t const levelEnd = side.penguinPositions.size();
+		for (std::size_t index = side.levelBegin; index < levelEnd; ++index) {
+			PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT> const p = side.penguinPositions.getState(index);
+			if (isForward) {
+				for (auto it = board.getStopCellEdgesBegin(p.getPos()); it != board.getStopCellEdgesEnd(p.getPos()); ++it) {
+					std::bitset<PRESENT_COUNT> const presentState = p.getPresentState() & it->keepMask;
+					if (!side.knownPositions[it->target].hasValueOrSubsetThereof(presentState)) {
+						side.knownPositions[it->target].insertValueEvictingSupersets(presentState);
+						side.penguinPositions.add(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(it->target, presentState), index, it->direction);
+					}
+				}
+			} else {
+				for (auto it = board.getStopCellPredecessorsBegin(p.getPos()); it != board.getStopCellPredecessorsEnd(p.getPos()); ++it) {
+					std::bitset<PRESENT_COUNT> const presentState = p.getPresentState() & it->keepMask;
+					if (!side.knownPositions[it->origin].hasValueOrSubsetThereof(presentState)) {
+						side.knownPositions[it->origin].insertValueEvictingSupersets(presentState);
+						side.penguinPositions.add(PackedState<NUM_ROWS * NUM_COLS, PRESENT_COUNT>(it->origin, presentState), index, it->direction);
+					}
+				}
+			}
+		}
+		expandedCount += levelEnd - side.levelBegin;
+		side.levelBegin = levelEnd;
+		++side.depth;
+
+		isMet = isForward ? findMeetingStates(forward, backward, closure, forwardIndex, backwardIndex) : findMeetingStates(backward, forward, closure, backwardIndex, forwardIndex);
+		auto const us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - beginSearch).count();
+		std::cout << "Depth " << forward.depth << " forward with " << forward.penguinPositions.size() << " states, " << backward.depth << " backward with " << backward.penguinPositions.size() << " states, " << (static_cast<double>(us) / 1000.0) << " ms" << std::endl;
+	}
+
+	if (!isMet) {
+		if ((options.maxMoves > 0) && ((forward.getLevelSize() > 0) || (backward.getLevelSize() > 0))) {
+			std::cout << "There is no solution with at most " << options.maxMoves << " moves." << std::endl;
+		} else {
+			std::cout << "Oh - no more states to explore - maybe there is no solution?" << std::endl;
+		}
+		return expandedCount;
+	}
+
+	// The backward log leads from the targets to the meeting cell, so its moves are in reverse
+	std::string const backwardMoves = backward.penguinPositions.getMoves(backwardIndex);
+	std::string const moves = forward.penguinPositions.getMoves(forwardIndex) + std::string(backwardMoves.rbegin(), backwardMoves.rend());
+	std::cout << "Met after " << forward.depth << " moves forward and " << backward.depth << " moves backward, expanded " << expandedCount << " states." << std::endl;
+	std::cout << "Terminating search, found a solution collecting all presents: " << moves << std::endl;
+	return expandedCount;
+}
+
+#endif
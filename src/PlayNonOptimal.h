@@ -2,71 +2,122 @@
 #define PLAYNONOPTIMAL_H_
 
 #include <array>
+#include <bitset>
+#include <chrono>
 #include <cstdint>
-#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <string>
 #include <vector>
 
+#include "Board.h"
+#include "DistanceOracle.h"
+#include "SearchOptions.h"
 
+/*
+	Quickly finds some solution without any guarantee of optimality, its length is an upper bound for the exact engines. Returns an empty string if every run failed.
+	A run walks from present to present: a BFS over the stop cells, with the presents left fixed, finds the nearest slides collecting at least one of them and takes one.
+	Once all presents are collected, the DistanceOracle leads to a target. Targets are only entered by a slide collecting the last presents, as they end the game.
+	The first run always takes the first of the nearest slides, all others pick one at random with a fixed seed. The shortest solution of all runs is returned.
+*/
 template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
-void playNonOptimal(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections) {
-	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections);
-	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> board = init.first;
-	PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> presentOverlay = init.second;
-
-	std::size_t pos = board.getPenguinStartingPosition();
+std::string findGreedySolution(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const& presentOverlay, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle, std::size_t const& runCount) {
+	std::uint32_t const unseen = std::numeric_limits<std::uint32_t>::max();
+	std::size_t const stopCellCount = board.getStopCellCount();
 
-	std::size_t newPos;
-	std::size_t target;
+	// The BFS of one step, a cell belongs to it if its stamp is the one of the step, so nothing has to be cleared in between
+	std::vector<std::uint32_t> stamps(stopCellCount, unseen);
+	std::vector<std::uint32_t> parents(stopCellCount, unseen);
+	std::vector<Direction> directions(stopCellCount, Direction::UP);
+	std::vector<std::uint32_t> queue;
+	queue.reserve(stopCellCount);
+	std::vector<std::pair<std::uint32_t, StopCellEdge<PRESENT_COUNT> const*>> nearestSlides;
+	std::string path;
 
-	std::cout << "Started in position X = " << getX<NUM_COLS>(pos) << ", Y = " << getY<NUM_COLS>(pos) << "." << std::endl;
-	for (std::size_t i = 0; i < moves.size(); ++i) {
-		if (board.getPieceAt(pos) == BoardPiece::TARGET) {
-			std::cout << "Found target with " << presentOverlay.getPresentsLeft() << " presents left using moves '" << moves << "'." << std::endl;
-			return;
-		}
+	std::mt19937_64 generator(19);
+	std::uint32_t stamp = 0;
+	std::string result = "";
+	for (std::size_t run = 0; run < runCount; ++run) {
+		std::uint32_t stopCell = static_cast<std::uint32_t>(board.getStartingStopCell());
+		std::bitset<PRESENT_COUNT> presentState = presentOverlay.getRepresentation();
+		std::string moves = "";
 
-		char const move = moves.at(i);
-		switch (move) {
-			case 'U':
-				if (board.canMoveUp(pos, target)) {
-					pos = board.moveUp(pos, presentOverlay);
-					std::cout << "Moved U to position X = " << std::setw(2) << std::setfill(' ') << getX<NUM_COLS>(pos) << ", Y = " << std::setw(2) << std::setfill(' ') << getY<NUM_COLS>(pos) << "." << std::endl;
-				} else {
-					std::cout << "Failed to move U in position X = " << std::setw(2) << std::setfill(' ') << getX<NUM_COLS>(pos) << ", Y = " << std::setw(2) << std::setfill(' ') << getY<NUM_COLS>(pos) << "." << std::endl;
-				}
-				break;
-			case 'D':
-				if (board.canMoveDown(pos, target)) {
-					pos = board.moveDown(pos, presentOverlay);
-					std::cout << "Moved D to position X = " << std::setw(2) << std::setfill(' ') << getX<NUM_COLS>(pos) << ", Y = " << std::setw(2) << std::setfill(' ') << getY<NUM_COLS>(pos) << "." << std::endl;
-				} else {
-					std::cout << "Failed to move D in position X = " << std::setw(2) << std::setfill(' ') << getX<NUM_COLS>(pos) << ", Y = " << std::setw(2) << std::setfill(' ') << getY<NUM_COLS>(pos) << "." << std::endl;
-				}
-				break;
-			case 'L':
-				if (board.canMoveLeft(pos, target)) {
-					pos = board.moveLeft(pos, presentOverlay);
-					std::cout << "Moved L to position X = " << std::setw(2) << std::setfill(' ') << getX<NUM_COLS>(pos) << ", Y = " << std::setw(2) << std::setfill(' ') << getY<NUM_COLS>(pos) << "." << std::endl;
-				} else {
-					std::cout << "Failed to move L in position X = " << std::setw(2) << std::setfill(' ') << getX<NUM_COLS>(pos) << ", Y = " << std::setw(2) << std::setfill(' ') << getY<NUM_COLS>(pos) << "." << std::endl;
-				}
-				break;
-			case 'R':
-				if (board.canMoveRight(pos, target)) {
-					pos = board.moveRight(pos, presentOverlay);
-					std::cout << "Moved R to position X = " << std::setw(2) << std::setfill(' ') << getX<NUM_COLS>(pos) << ", Y = " << std::setw(2) << std::setfill(' ') << getY<NUM_COLS>(pos) << "." << std::endl;
-				} else {
-					std::cout << "Failed to move R in position X = " << std::setw(2) << std::setfill(' ') << getX<NUM_COLS>(pos) << ", Y = " << std::setw(2) << std::setfill(' ') << getY<NUM_COLS>(pos) << "." << std::endl;
+		// Stops early once the run can not beat the best one anymore
+		while (presentState.any() && (result.empty() || (moves.size() < result.size()))) {
+			++stamp;
+			stamps[stopCell] = stamp;
+			parents[stopCell] = unseen;
+			queue.clear();
+			queue.push_back(stopCell);
+			nearestSlides.clear();
+			std::size_t levelEnd = queue.size();
+			for (std::size_t head = 0; (head < queue.size()) && nearestSlides.empty(); levelEnd = queue.size()) {
+				for (; head < levelEnd; ++head) {
+					std::uint32_t const current = queue[head];
+					for (auto it = board.getStopCellEdgesBegin(current); it != board.getStopCellEdgesEnd(current); ++it) {
+						if (oracle.getDistance(it->target) == DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE) {
+							continue;
+						}
+						std::bitset<PRESENT_COUNT> const childState = presentState & it->keepMask;
+						if (childState != presentState) {
+							if (childState.none() || !board.isTargetStopCell(it->target)) {
+								nearestSlides.push_back(std::make_pair(current, it));
+							}
+						} else if (!board.isTargetStopCell(it->target) && (stamps[it->target] != stamp)) {
+							stamps[it->target] = stamp;
+							parents[it->target] = current;
+							directions[it->target] = it->direction;
+							queue.push_back(it->target);
+						}
+					}
 				}
+			}
+
+			if (nearestSlides.empty()) {
 				break;
-			default:
-				std::cerr << "Invalid move '" << move << "'!" << std::endl;
-				exit(-1);
+			}
+			std::size_t const chosen = (run == 0) ? 0 : std::uniform_int_distribution<std::size_t>(0, nearestSlides.size() - 1)(generator);
+			StopCellEdge<PRESENT_COUNT> const& slide = *nearestSlides[chosen].second;
+
+			path.clear();
+			path.push_back(directionToChar(slide.direction));
+			for (std::uint32_t cell = nearestSlides[chosen].first; parents[cell] != unseen; cell = parents[cell]) {
+				path.push_back(directionToChar(directions[cell]));
+			}
+			moves.append(path.rbegin(), path.rend());
+			stopCell = slide.target;
+			presentState &= slide.keepMask;
+		}
+
+		if (presentState.any() || (oracle.getDistance(stopCell) == DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE)) {
+			continue;
+		}
+		moves += oracle.getMovesToTarget(board, stopCell);
+		if (result.empty() || (moves.size() < result.size())) {
+			result = moves;
 		}
 	}
+	return result;
 }
 
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t playNonOptimal(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections);
+	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board = init.first;
+	DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const oracle(board);
+
+	auto const beginSearch = std::chrono::steady_clock::now();
+	std::string const moves = findGreedySolution(board, init.second, oracle, options.greedyRuns);
+	auto const endSearch = std::chrono::steady_clock::now();
+	std::cout << "Greedy runs: " << options.greedyRuns << " in " << std::chrono::duration_cast<std::chrono::microseconds>(endSearch - beginSearch).count() << " us." << std::endl;
+
+	if (moves.empty() && (board.getStopCellCount() > 0) && !board.isTargetStopCell(board.getStartingStopCell())) {
+		std::cout << "Oh - no greedy run reached a target with all presents collected, maybe there is no solution?" << std::endl;
+		return options.greedyRuns;
+	}
+	std::cout << "Terminating search, found a solution collecting all presents: " << moves << std::endl;
+	return options.greedyRuns;
+}
 
 #endif
@@ -0,0 +1,56 @@
+#ifndef PLAYTABLEBASE_H_
+#define PLAYTABLEBASE_H_
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "SearchOptions.h"
+#include "Tablebase.h"
+
+/*
+	Answers from the Tablebase, building it first if there is none for this board yet.
+	The moves given by --play are played first, so any position reached by them is finished in the shortest possible way.
+	Moves that are not possible leave the penguin where it is, as with --play alone.
+	Returns the number of moves looked up.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t playTablebase(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections);
+	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board = init.first;
+	std::string const filename = options.tablebaseFilename.empty() ? Tablebase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::getDefaultFilename(board) : options.tablebaseFilename;
+	Tablebase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const tablebase(board, filename);
+
+	std::size_t stopCell = board.getStartingStopCell();
+	std::bitset<PRESENT_COUNT> presentState = init.second.getRepresentation();
+	std::string moves = "";
+	for (auto itM = options.startingMoves.cbegin(); (itM != options.startingMoves.cend()) && !board.isTargetStopCell(stopCell); ++itM) {
+		for (auto it = board.getStopCellEdgesBegin(stopCell); it != board.getStopCellEdgesEnd(stopCell); ++it) {
+			if (directionToChar(it->direction) == *itM) {
+				stopCell = it->target;
+				presentState &= it->keepMask;
+				moves.push_back(*itM);
+				break;
+			}
+		}
+	}
+	if (!options.startingMoves.empty()) {
+		std::cout << "Played " << moves.size() << " of the " << options.startingMoves.size() << " given moves, " << presentState.count() << " presents are left." << std::endl;
+	}
+
+	std::uint32_t const distance = tablebase.getDistance(stopCell, presentState);
+	if (distance == Tablebase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE) {
+		std::cout << "Oh - there is no way to collect all presents from here." << std::endl;
+		return moves.size();
+	}
+	std::cout << "The shortest way to finish takes " << distance << " moves." << std::endl;
+	moves += tablebase.getMovesToTarget(board, stopCell, presentState);
+	std::cout << "Terminating search, found a solution collecting all presents: " << moves << std::endl;
+	return moves.size();
+}
+
+#endif
@@ -24,11 +24,11 @@ template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t
 std::size_t playString(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, std::string const& moves) {
 	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections);
 	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> board = init.first;
-	PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> presentOverlay = init.second;
+	PresentOverlay<NUM_ROWS, NUM_COLS, PRESENT_COUNT> const& presentBaseOverlay = init.second;
+	PresentOverlayView<NUM_ROWS, NUM_COLS, PRESENT_COUNT> presentOverlay = presentBaseOverlay.getView();
 
 	std::size_t pos = board.getPenguinStartingPosition();
 
-	std::size_t newPos;
 	std::size_t target;
 
 	std::size_t roundCounter = 0;
@@ -0,0 +1,38 @@
+#ifndef PLAYWITHHEURISTIC_H_
+#define PLAYWITHHEURISTIC_H_
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Board.h"
+#include "DistanceOracle.h"
+#include "PatternDatabase.h"
+#include "PresentDistances.h"
+#include "SearchOptions.h"
+
+/*
+	Sets up the board and the lower bound selected by --heuristic for the informed engines and runs search on them.
+	search is called as search(board, presentOverlay, oracle, heuristic) once for the selected HEURISTIC type, so it is usually a generic lambda forwarding to the engine.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT, typename SEARCH>
+std::size_t playWithHeuristic(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options, SEARCH const& search) {
+	auto const init = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections);
+	Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board = init.first;
+	DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const oracle(board);
+
+	switch (options.heuristic) {
+		case HeuristicType::PRESENT_DISTANCES: {
+			PresentDistances<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const heuristic(board, oracle);
+			return search(board, init.second, oracle, heuristic);
+		}
+		case HeuristicType::PATTERN_DATABASE:
+		default: {
+			PatternDatabase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const heuristic(board, oracle, options.pdbGroupSize);
+			return search(board, init.second, oracle, heuristic);
+		}
+	}
+}
+
+#endif
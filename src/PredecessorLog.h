@@ -0,0 +1,110 @@
+#ifndef PREDECESSORLOG_H_
+#define PREDECESSORLOG_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "PackedState.h"
+
+/*
+	Records every discovered search state in discovery order, together with the index of the state it was reached from and the direction used.
+	Move strings are only rebuilt on demand by following the parent indices back to the root.
+	As states are appended in BFS order, the log doubles as the search queue.
+	Both are stored in chunks of CHUNK_SIZE entries, so growing never copies the log. Once a queue has moved past states it no longer reads,
+	their chunks can be given back with releaseStatesBefore(), the parents are always kept for getMoves().
+*/
+template <std::size_t CELL_COUNT, std::size_t PRESENT_COUNT>
+class PredecessorLog {
+public:
+	static constexpr std::uint64_t NO_PARENT = std::numeric_limits<std::uint64_t>::max() >> 2;
+	static constexpr std::size_t CHUNK_BITS = 20;
+	static constexpr std::size_t CHUNK_SIZE = std::size_t(1) << CHUNK_BITS;
+
+	PredecessorLog() : m_stateChunks(), m_parentChunks(), m_size(0), m_releasedChunkCount(0) {
+		//
+	}
+	~PredecessorLog() {
+		//
+	}
+
+	inline std::size_t addRoot(PackedState<CELL_COUNT, PRESENT_COUNT> const& state) {
+		return add(state, NO_PARENT, Direction::UP);
+	}
+
+	inline std::size_t add(PackedState<CELL_COUNT, PRESENT_COUNT> const& state, std::uint64_t const& parent, Direction const& direction) {
+		std::size_t const result = m_size;
+		if ((result & (CHUNK_SIZE - 1)) == 0) {
+			m_stateChunks.emplace_back();
+			m_stateChunks.back().reserve(CHUNK_SIZE);
+			m_parentChunks.emplace_back();
+			m_parentChunks.back().reserve(CHUNK_SIZE);
+		}
+		m_stateChunks.back().push_back(state);
+		m_parentChunks.back().push_back((parent << 2) | static_cast<std::uint64_t>(direction));
+		++m_size;
+		return result;
+	}
+
+	// Only valid for states that have not been released.
+	inline PackedState<CELL_COUNT, PRESENT_COUNT> const& getState(std::size_t const& index) const {
+#ifdef _DEBUG
+		if ((index >> CHUNK_BITS) < m_releasedChunkCount) throw;
+#endif
+		return m_stateChunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)];
+	}
+
+	inline std::size_t size() const noexcept(true) {
+		return m_size;
+	}
+
+	// Frees the chunks of states that only hold states before index, which can not be read with getState() afterwards.
+	void releaseStatesBefore(std::size_t const& index) {
+		std::size_t const chunkCount = index >> CHUNK_BITS;
+		for (; m_releasedChunkCount < chunkCount; ++m_releasedChunkCount) {
+			std::vector<PackedState<CELL_COUNT, PRESENT_COUNT>>().swap(m_stateChunks[m_releasedChunkCount]);
+		}
+	}
+
+	std::string getMoves(std::size_t index) const {
+		std::string result;
+		while ((getParent(index) >> 2) != NO_PARENT) {
+			result.push_back(directionToChar(static_cast<Direction>(getParent(index) & 0x3)));
+			index = static_cast<std::size_t>(getParent(index) >> 2);
+		}
+		std::reverse(result.begin(), result.end());
+		return result;
+	}
+
+	// Released chunks are written empty
+	template<class Archive>
+	void save(Archive& archive) const {
+		archive(m_size, m_releasedChunkCount, m_stateChunks, m_parentChunks);
+	}
+
+	template<class Archive>
+	void load(Archive& archive) {
+		archive(m_size, m_releasedChunkCount, m_stateChunks, m_parentChunks);
+		// A partly filled last chunk is still appended to, so it gets its full size again
+		if ((m_size & (CHUNK_SIZE - 1)) != 0) {
+			m_stateChunks.back().reserve(CHUNK_SIZE);
+			m_parentChunks.back().reserve(CHUNK_SIZE);
+		}
+	}
+private:
+	inline std::uint64_t const& getParent(std::size_t const& index) const {
+		return m_parentChunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)];
+	}
+
+	std::vector<std::vector<PackedState<CELL_COUNT, PRESENT_COUNT>>> m_stateChunks;
+	// Parent index shifted left by two, the lowest two bits hold the direction.
+	std::vector<std::vector<std::uint64_t>> m_parentChunks;
+	std::size_t m_size;
+	// All chunks of states before this one have been released
+	std::size_t m_releasedChunkCount;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef PRESENTDISTANCES_H_
+#define PRESENTDISTANCES_H_
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+#include "DistanceOracle.h"
+
+/*
+	For every present and stop cell, the number of moves needed to collect that present and then reach a target, ignoring all other presents.
+	Every solution has to collect each present still on the board, so the largest of these over the presents left, together with the distance
+	from the DistanceOracle, is an admissible lower bound for the remaining moves of a state.
+	The bound is also consistent: a move lowers each of its parts by at most one, and collecting a present drops its part in favour of the
+	oracle distance of the cell it was collected on the way to, which the part already included.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+class PresentDistances {
+public:
+	static constexpr std::uint32_t UNREACHABLE = DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::UNREACHABLE;
+
+	PresentDistances(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle) : m_oracle(oracle), m_distances(buildDistances(board, oracle)) {
+		//
+	}
+	~PresentDistances() {
+		//
+	}
+
+	inline std::uint32_t getDistance(std::size_t const& stopCell, std::size_t const& present) const {
+		return m_distances[stopCell * PRESENT_COUNT + present];
+	}
+
+	/*
+		The lower bound for the remaining moves of the state, UNREACHABLE if the state can not be finished at all.
+		For states without presents left, this is the exact remaining distance.
+	*/
+	inline std::uint32_t getLowerBound(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		std::uint32_t result = m_oracle.getDistance(stopCell);
+		if constexpr (PRESENT_COUNT > 0) {
+			std::uint32_t const* const distances = m_distances.data() + stopCell * PRESENT_COUNT;
+			std::uint64_t bits = presentState.to_ullong();
+			for (std::size_t present = 0; bits != 0; ++present, bits >>= 1) {
+				if ((bits & 1u) != 0) {
+					result = std::max(result, distances[present]);
+				}
+			}
+		}
+		return result;
+	}
+private:
+	/*
+		Per present, a shortest path search backwards over the predecessors of the stop cell graph, with two layers:
+		a slide collecting the present reaches the oracle distance of its target in one move, any other slide keeps the present to be collected.
+		The slides collecting it start at different distances, so the cells are handled in buckets of increasing distance.
+	*/
+	static std::vector<std::uint32_t> buildDistances(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& oracle) {
+		std::size_t const stopCellCount = board.getStopCellCount();
+		std::vector<std::uint32_t> result(stopCellCount * PRESENT_COUNT, UNREACHABLE);
+		std::vector<std::uint32_t> distances(stopCellCount);
+		std::vector<std::vector<std::uint32_t>> buckets;
+		for (std::size_t present = 0; present < PRESENT_COUNT; ++present) {
+			std::fill(distances.begin(), distances.end(), UNREACHABLE);
+			buckets.clear();
+			for (std::size_t stopCell = 0; stopCell < stopCellCount; ++stopCell) {
+				for (auto it = board.getStopCellEdgesBegin(stopCell); it != board.getStopCellEdgesEnd(stopCell); ++it) {
+					std::uint32_t const remaining = oracle.getDistance(it->target);
+					if (!it->keepMask.test(present) && (remaining != UNREACHABLE) && (remaining + 1 < distances[stopCell])) {
+						distances[stopCell] = remaining + 1;
+					}
+				}
+				if (distances[stopCell] != UNREACHABLE) {
+					if (buckets.size() <= distances[stopCell]) {
+						buckets.resize(distances[stopCell] + 1);
+					}
+					buckets[distances[stopCell]].push_back(static_cast<std::uint32_t>(stopCell));
+				}
+			}
+
+			for (std::size_t distance = 0; distance < buckets.size(); ++distance) {
+				for (std::size_t i = 0; i < buckets[distance].size(); ++i) {
+					std::uint32_t const stopCell = buckets[distance][i];
+					if (distances[stopCell] != distance) {
+						continue;
+					}
+					for (auto it = board.getStopCellPredecessorsBegin(stopCell); it != board.getStopCellPredecessorsEnd(stopCell); ++it) {
+						if (it->keepMask.test(present) && (distance + 1 < distances[it->origin])) {
+							distances[it->origin] = static_cast<std::uint32_t>(distance + 1);
+							if (buckets.size() <= distance + 1) {
+								buckets.resize(distance + 2);
+							}
+							buckets[distance + 1].push_back(it->origin);
+						}
+					}
+				}
+			}
+
+			for (std::size_t stopCell = 0; stopCell < stopCellCount; ++stopCell) {
+				result[stopCell * PRESENT_COUNT + present] = distances[stopCell];
+			}
+		}
+		return result;
+	}
+
+	DistanceOracle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& m_oracle;
+	std::vector<std::uint32_t> const m_distances;
+};
+
+#endif
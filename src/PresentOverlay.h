@@ -9,7 +9,7 @@
 template<std::size_t NUM_ROWS, std::size_t NUM_COLS>
 class PresentBase {
 public:
-	PresentBase(std::vector<std::size_t> presentCoordinates) {
+	PresentBase(std::vector<std::size_t> presentCoordinates) : m_mapToBitset(NUM_ROWS * NUM_COLS, std::numeric_limits<std::size_t>::max()), m_totalPresentCount(0) {
 		std::sort(presentCoordinates.begin(), presentCoordinates.end());
 
 		if (presentCoordinates.size() > 32) {
@@ -17,11 +17,6 @@ public:
 			exit(-1);
 		}
 
-		// Mark as "not mapped"
-		for (std::size_t i = 0; i < m_mapToBitset.size(); ++i) {
-			m_mapToBitset[i] = std::numeric_limits<std::size_t>::max();
-		}
-
 		std::size_t indexCounter = 0;
 		for (auto it = presentCoordinates.cbegin(); it != presentCoordinates.cend(); ++it) {
 			if (*it >= (NUM_ROWS * NUM_COLS)) {
@@ -46,24 +41,23 @@ public:
 		return m_totalPresentCount;
 	}
 private:
-	std::array<std::size_t, (NUM_ROWS* NUM_COLS)> m_mapToBitset;
+	// Per cell, so on the heap: large boards would not fit on the stack. Cells without a present are "not mapped" (max).
+	std::vector<std::size_t> m_mapToBitset;
 	std::size_t m_totalPresentCount;
 };
 
+/*
+	Same interface as PresentOverlay, but only references the (immutable) PresentBase instead of copying it.
+	The referenced base has to outlive the view.
+*/
 template<std::size_t NUM_ROWS, std::size_t NUM_COLS, std::size_t BIT_COUNT>
-class PresentOverlay {
+class PresentOverlayView {
 public:
-	PresentOverlay(PresentBase<NUM_ROWS, NUM_COLS> const& base) : m_presentBase(base) {
-		m_presents.reset();
-		for (std::size_t i = 0; i < m_presentBase.getTotalPresentCount(); ++i) {
-			m_presents[i] = true;
-		}
-	}
-	PresentOverlay(PresentBase<NUM_ROWS, NUM_COLS> const& base, std::bitset<BIT_COUNT> const& presents) : m_presentBase(base), m_presents(presents) {
+	PresentOverlayView(PresentBase<NUM_ROWS, NUM_COLS> const& base, std::bitset<BIT_COUNT> const& presents) : m_presentBase(base), m_presents(presents) {
 		//
 	}
 
-	~PresentOverlay() {
+	~PresentOverlayView() {
 		//
 	}
 
@@ -94,9 +88,65 @@ public:
 		return m_presentBase;
 	}
 private:
-	PresentBase<NUM_ROWS, NUM_COLS> const m_presentBase;
+	PresentBase<NUM_ROWS, NUM_COLS> const& m_presentBase;
 	std::bitset<BIT_COUNT> m_presents;
 };
 
+/*
+	Owns a copy of its PresentBase and leaves the present state to a PresentOverlayView on it.
+	Copies get a view on their own base, so they stay valid when the original is gone.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, std::size_t BIT_COUNT>
+class PresentOverlay {
+public:
+	PresentOverlay(PresentBase<NUM_ROWS, NUM_COLS> const& base) : m_presentBase(base), m_view(m_presentBase, getAllPresents(m_presentBase)) {
+		//
+	}
+	PresentOverlay(PresentBase<NUM_ROWS, NUM_COLS> const& base, std::bitset<BIT_COUNT> const& presents) : m_presentBase(base), m_view(m_presentBase, presents) {
+		//
+	}
+	PresentOverlay(PresentOverlay const& other) : m_presentBase(other.m_presentBase), m_view(m_presentBase, other.getRepresentation()) {
+		//
+	}
+
+	~PresentOverlay() {
+		//
+	}
+
+	void collectOn(std::size_t const& pos) {
+		m_view.collectOn(pos);
+	}
+
+	inline std::size_t getPresentsLeft() const {
+		return m_view.getPresentsLeft();
+	}
+
+	inline std::size_t getPresentsCollected() const {
+		return m_view.getPresentsCollected();
+	}
+
+	inline std::bitset<BIT_COUNT> const& getRepresentation() const noexcept(true) {
+		return m_view.getRepresentation();
+	}
+
+	inline PresentBase<NUM_ROWS, NUM_COLS> const& getBase() const noexcept(true) {
+		return m_presentBase;
+	}
+
+	inline PresentOverlayView<NUM_ROWS, NUM_COLS, BIT_COUNT> getView() const {
+		return m_view;
+	}
+private:
+	static std::bitset<BIT_COUNT> getAllPresents(PresentBase<NUM_ROWS, NUM_COLS> const& base) {
+		std::bitset<BIT_COUNT> result;
+		for (std::size_t i = 0; i < base.getTotalPresentCount(); ++i) {
+			result[i] = true;
+		}
+		return result;
+	}
+
+	PresentBase<NUM_ROWS, NUM_COLS> const m_presentBase;
+	PresentOverlayView<NUM_ROWS, NUM_COLS, BIT_COUNT> m_view;
+};
 
 #endif
@@ -0,0 +1,68 @@
+#ifndef SEARCHOPTIONS_H_
+#define SEARCHOPTIONS_H_
+
+#include <cstdint>
+#include <string>
+
+enum class VisitedSetType {
+	AUTO,
+	DENSE,
+	TRIE,
+	STRIDE_TRIE_2,
+	STRIDE_TRIE_4,
+	ANTICHAIN,
+	ZDD
+};
+
+enum class SearchEngine {
+	BFS,
+	BIDIRECTIONAL,
+	ASTAR,
+	IDASTAR,
+	BRANCH_AND_BOUND,
+	BEAM,
+	GREEDY,
+	MEET_IN_THE_MIDDLE,
+	TABLEBASE
+};
+
+enum class HeuristicType {
+	PRESENT_DISTANCES,
+	PATTERN_DATABASE
+};
+
+struct SearchOptions {
+public:
+	SearchOptions() : deleteOldBackups(false), noBackups(false), stateFilename(""), threadCount(1), engine(SearchEngine::BFS), heuristic(HeuristicType::PATTERN_DATABASE), pdbGroupSize(6), transpositionTableMemory(std::uint64_t(1024) * 1024 * 1024), maxMoves(0), beamWidth(10000), greedyRuns(1000), useGreedyBound(false), endgamePresentCount(0), tablebaseFilename(""), startingMoves(""), visitedSet(VisitedSetType::AUTO), denseMemoryLimit(std::uint64_t(4096) * 1024 * 1024) {
+		//
+	}
+
+	bool deleteOldBackups;
+	bool noBackups;
+	std::string stateFilename;
+	std::size_t threadCount;
+	SearchEngine engine;
+	// The lower bound used by informed engines, with the number of presents per pattern database table.
+	HeuristicType heuristic;
+	std::size_t pdbGroupSize;
+	// The memory of the transposition table of SearchEngine::IDASTAR and the depth table of SearchEngine::BRANCH_AND_BOUND, in bytes.
+	std::uint64_t transpositionTableMemory;
+	// Only look for solutions with at most this many moves, 0 for no limit. Used by SearchEngine::BRANCH_AND_BOUND and SearchEngine::MEET_IN_THE_MIDDLE.
+	std::size_t maxMoves;
+	// The number of states SearchEngine::BEAM keeps per level.
+	std::size_t beamWidth;
+	// The number of randomized runs of SearchEngine::GREEDY, also used for the upper bound SearchEngine::BFS starts with if useGreedyBound is set.
+	std::size_t greedyRuns;
+	bool useGreedyBound;
+	// SearchEngine::BFS finishes states with at most this many presents left by a lookup in an EndgameDatabase, 0 for none.
+	std::size_t endgamePresentCount;
+	// The file of SearchEngine::TABLEBASE, empty for one named after the board in the working directory.
+	std::string tablebaseFilename;
+	// Moves played before the position SearchEngine::TABLEBASE answers for.
+	std::string startingMoves;
+	VisitedSetType visitedSet;
+	// The memory VisitedSetType::AUTO may use for dense visited sets, in bytes.
+	std::uint64_t denseMemoryLimit;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef STATEBACKUP_H_
+#define STATEBACKUP_H_
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <cereal/cereal.hpp>
+#include <cereal/archives/binary.hpp>
+
+#include "SearchOptions.h"
+
+#include "lz4_stream.h"
+
+/*
+	Writes the values to a new state backup, deletes the last one if --deleteOldBackups is given and makes the new one the last.
+	The engines read the values back in the same order when resuming, see play(), searchAStar() and searchIdaStar().
+*/
+template<typename... VALUES>
+void writeStateBackup(std::string const& filename, std::string& lastBackupFilename, SearchOptions const& options, VALUES const&... values) {
+	auto const beginBackup = std::chrono::steady_clock::now();
+	{
+		std::ofstream os(filename, std::ios::binary);
+		lz4_stream::ostream compressedStream(os);
+		cereal::BinaryOutputArchive archive(compressedStream);
+		archive(values...);
+	}
+	auto const endBackup = std::chrono::steady_clock::now();
+	std::cout << "Made a state backup '" << filename << "' in " << std::chrono::duration_cast<std::chrono::milliseconds>(endBackup - beginBackup).count() << " ms." << std::endl;
+
+	if (options.deleteOldBackups && !lastBackupFilename.empty()) {
+		if (std::filesystem::remove(lastBackupFilename)) {
+			std::cout << "Deleted last backup '" << lastBackupFilename << "'." << std::endl;
+		} else {
+			std::cerr << "Failed to delete last backup '" << lastBackupFilename << "'!" << std::endl;
+		}
+	}
+	lastBackupFilename = filename;
+}
+
+#endif
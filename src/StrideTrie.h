@@ -0,0 +1,210 @@
+#ifndef STRIDETRIE_H_
+#define STRIDETRIE_H_
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+/*
+	Same interface as Trie, but consumes STRIDE_BITS bits per level instead of one.
+	This shortens every path from BIT_COUNT to ceil(BIT_COUNT / STRIDE_BITS) dependent node accesses.
+	The subset query only follows children whose bit pattern is a subset of the corresponding bits of the queried value.
+*/
+template <std::size_t BIT_COUNT, std::size_t STRIDE_BITS = 4>
+class StrideTrie {
+public:
+	static_assert(STRIDE_BITS >= 1 && STRIDE_BITS <= 8, "StrideTrie supports between 1 and 8 bits per level.");
+	static_assert(BIT_COUNT <= 64, "StrideTrie supports at most 64 bits.");
+
+	static constexpr std::size_t LEVEL_COUNT = (BIT_COUNT + STRIDE_BITS - 1) / STRIDE_BITS;
+	static constexpr std::size_t CHILD_COUNT = std::size_t(1) << STRIDE_BITS;
+
+	// The name of --visited, also written to state backups, see play()
+	static std::string getName() {
+		return "stride" + std::to_string(STRIDE_BITS);
+	}
+
+	StrideTrie() : m_nodes(), m_freeListHead(0) {
+		//
+	}
+	~StrideTrie() {
+		//
+	}
+
+	bool hasValueOrSubsetThereof(std::bitset<BIT_COUNT> const& value) const {
+		if (m_nodes.size() == 0) {
+			return false;
+		}
+		if constexpr(BIT_COUNT == 0) {
+			return true;
+		} else {
+			std::uint64_t const bits = value.to_ullong();
+			// Every level can leave up to CHILD_COUNT - 1 branches pending.
+			std::array<PendingBranch, LEVEL_COUNT * CHILD_COUNT> stack;
+			std::size_t stackSize = 0;
+			stack[stackSize++] = PendingBranch(0, 0);
+			while (stackSize > 0) {
+				--stackSize;
+				std::uint32_t const nodeIndex = stack[stackSize].nodeIndex;
+				std::size_t const level = stack[stackSize].level;
+				StrideTrieNode const& node = m_nodes[nodeIndex];
+				std::size_t const chunk = getChunk(bits, level);
+
+				// Enumerate all subsets of the chunk
+				std::size_t subset = chunk;
+				while (true) {
+					std::uint32_t const child = node.children[subset];
+					if (child != 0) {
+						if (level + 1 >= LEVEL_COUNT) {
+							return true;
+						}
+						stack[stackSize++] = PendingBranch(child, level + 1);
+					}
+					if (subset == 0) {
+						break;
+					}
+					subset = (subset - 1) & chunk;
+				}
+			}
+			return false;
+		}
+	}
+
+	void insertValue(std::bitset<BIT_COUNT> const& value) {
+		if (m_nodes.size() == 0) {
+			makeNode();
+		}
+		if constexpr(BIT_COUNT == 0) {
+			return;
+		} else {
+			std::uint64_t const bits = value.to_ullong();
+			std::uint32_t nodeIndex = 0;
+			for (std::size_t level = 0; level < LEVEL_COUNT; ++level) {
+				std::size_t const chunk = getChunk(bits, level);
+				if (level + 1 >= LEVEL_COUNT) {
+					// Leaves are not materialized
+					m_nodes[nodeIndex].children[chunk] = LEAF;
+				} else {
+					if (m_nodes[nodeIndex].children[chunk] == 0) {
+						std::uint32_t const child = makeNode();
+						m_nodes[nodeIndex].children[chunk] = child;
+					}
+					nodeIndex = m_nodes[nodeIndex].children[chunk];
+				}
+			}
+		}
+	}
+
+	/*
+		Inserts the value and removes all stored supersets of it, reclaiming nodes that become unused. See Trie.
+	*/
+	void insertValueEvictingSupersets(std::bitset<BIT_COUNT> const& value) {
+		if constexpr(BIT_COUNT > 0) {
+			if (m_nodes.size() > 0) {
+				removeSupersets(0, value.to_ullong(), 0);
+			}
+		}
+		insertValue(value);
+	}
+
+	template<class Archive>
+	void serialize(Archive& archive) {
+		archive(m_nodes, m_freeListHead);
+	}
+private:
+	static constexpr std::uint32_t LEAF = std::numeric_limits<std::uint32_t>::max();
+
+	struct StrideTrieNode {
+	public:
+		StrideTrieNode() : children() {
+			children.fill(0);
+		}
+
+		// Indices into the node pool, 0 means "no child" and LEAF marks a stored value on the last level.
+		std::array<std::uint32_t, CHILD_COUNT> children;
+
+		template<class Archive>
+		void serialize(Archive& archive) {
+			archive(children);
+		}
+	};
+
+	struct PendingBranch {
+	public:
+		PendingBranch() : nodeIndex(0), level(0) {
+			//
+		}
+		PendingBranch(std::uint32_t const& nodeIndex, std::size_t const& level) : nodeIndex(nodeIndex), level(level) {
+			//
+		}
+
+		std::uint32_t nodeIndex;
+		std::size_t level;
+	};
+
+	static inline std::size_t getChunk(std::uint64_t const& bits, std::size_t const& level) {
+		return static_cast<std::size_t>((bits >> (level * STRIDE_BITS)) & (CHILD_COUNT - 1));
+	}
+
+	inline std::uint32_t makeNode() {
+		if (m_freeListHead != 0) {
+			std::uint32_t const result = m_freeListHead;
+			m_freeListHead = m_nodes[result].children[0];
+			m_nodes[result] = StrideTrieNode();
+			return result;
+		}
+		if (m_nodes.size() >= LEAF) {
+			std::cerr << "Internal Error: StrideTrie node pool exhausted, can not address more than 2^32 - 1 nodes." << std::endl;
+			exit(-1);
+		}
+		std::uint32_t const result = static_cast<std::uint32_t>(m_nodes.size());
+		m_nodes.push_back(StrideTrieNode());
+		return result;
+	}
+
+	inline void freeNode(std::uint32_t const& nodeIndex) {
+		m_nodes[nodeIndex].children[0] = m_freeListHead;
+		m_freeListHead = nodeIndex;
+	}
+
+	// Returns true if the node at nodeIndex no longer leads to any value and can be freed by its parent.
+	bool removeSupersets(std::uint32_t const& nodeIndex, std::uint64_t const& bits, std::size_t const& level) {
+		std::size_t const chunk = getChunk(bits, level);
+		bool const isLastLevel = (level + 1 >= LEVEL_COUNT);
+
+		// Enumerate all supersets of the chunk
+		std::size_t superset = chunk;
+		while (true) {
+			std::uint32_t const child = m_nodes[nodeIndex].children[superset];
+			if (child != 0) {
+				if (isLastLevel) {
+					m_nodes[nodeIndex].children[superset] = 0;
+				} else if (removeSupersets(child, bits, level + 1)) {
+					freeNode(child);
+					m_nodes[nodeIndex].children[superset] = 0;
+				}
+			}
+			if (superset == (CHILD_COUNT - 1)) {
+				break;
+			}
+			superset = (superset + 1) | chunk;
+		}
+
+		for (std::size_t i = 0; i < CHILD_COUNT; ++i) {
+			if (m_nodes[nodeIndex].children[i] != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<StrideTrieNode> m_nodes;
+	// First node of the list of reclaimed nodes, linked through children[0]. 0 if there are none.
+	std::uint32_t m_freeListHead;
+};
+
+#endif
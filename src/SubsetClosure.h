@@ -0,0 +1,61 @@
+#ifndef SUBSETCLOSURE_H_
+#define SUBSETCLOSURE_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/*
+	One bit for every subset of BIT_COUNT bits, answering in O(1) whether a query has one of the inserted values as a subset.
+	close() runs the zeta transform over subsets, with OR as the sum: after handling bit i, a set is marked if it or the set without bit i was marked.
+	The lowest six bits are handled within the words by shifts, all others by ORing whole words, so building takes BIT_COUNT * 2^BIT_COUNT / 64 word operations.
+	That only pays off for many queries against many values, for few of them a scan as in AntichainSet is cheaper.
+*/
+template <std::size_t BIT_COUNT>
+class SubsetClosure {
+public:
+	static_assert(BIT_COUNT <= 30, "SubsetClosure supports at most 30 bits.");
+
+	SubsetClosure() : m_words(((std::size_t(1) << BIT_COUNT) + 63) / 64, 0) {
+		//
+	}
+	~SubsetClosure() {
+		//
+	}
+
+	void clear() {
+		std::fill(m_words.begin(), m_words.end(), 0);
+	}
+
+	inline void insertValue(std::uint64_t const& bits) {
+		m_words[bits >> 6] |= std::uint64_t(1) << (bits & 63);
+	}
+
+	// Has to be called after the last insert and before the first query.
+	void close() {
+		// Selects the positions whose index has the given bit cleared
+		static constexpr std::array<std::uint64_t, 6> lowMasks = { 0x5555555555555555ull, 0x3333333333333333ull, 0x0F0F0F0F0F0F0F0Full, 0x00FF00FF00FF00FFull, 0x0000FFFF0000FFFFull, 0x00000000FFFFFFFFull };
+		for (std::size_t bit = 0; bit < std::min<std::size_t>(BIT_COUNT, 6); ++bit) {
+			for (auto it = m_words.begin(); it != m_words.end(); ++it) {
+				*it |= (*it & lowMasks[bit]) << (std::size_t(1) << bit);
+			}
+		}
+		for (std::size_t bit = 6; bit < BIT_COUNT; ++bit) {
+			std::size_t const stride = std::size_t(1) << (bit - 6);
+			for (std::size_t block = 0; block < m_words.size(); block += 2 * stride) {
+				for (std::size_t word = block; word < block + stride; ++word) {
+					m_words[word + stride] |= m_words[word];
+				}
+			}
+		}
+	}
+
+	inline bool hasValueOrSubsetThereof(std::uint64_t const& bits) const {
+		return ((m_words[bits >> 6] >> (bits & 63)) & 1u) != 0;
+	}
+private:
+	std::vector<std::uint64_t> m_words;
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef SUBSETSCAN_H_
+#define SUBSETSCAN_H_
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SUBSET_SCAN_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define SUBSET_SCAN_X86 0
+#endif
+
+// GCC and Clang need the instruction set enabled per function, MSVC allows the intrinsics anywhere.
+#if SUBSET_SCAN_X86 && !defined(_MSC_VER)
+#define SUBSET_SCAN_TARGET(ISA) __attribute__((target(ISA)))
+#else
+#define SUBSET_SCAN_TARGET(ISA)
+#endif
+
+/*
+	Kernels answering whether any of the given masks has none of the forbidden bits set, i.e. (mask & forbiddenBits) == 0.
+	With forbiddenBits = ~query, this is the test for a stored subset of the query.
+	The kernel is picked once at startup, according to what the CPU supports.
+*/
+typedef bool (*SubsetScanFunction)(std::uint32_t const* masks, std::size_t count, std::uint32_t forbiddenBits);
+
+inline bool containsSubsetScalar(std::uint32_t const* masks, std::size_t count, std::uint32_t forbiddenBits) {
+	std::size_t const blockSize = 16;
+	std::size_t i = 0;
+	for (; i + blockSize <= count; i += blockSize) {
+		std::uint32_t found = 0;
+		for (std::size_t j = 0; j < blockSize; ++j) {
+			found |= static_cast<std::uint32_t>((masks[i + j] & forbiddenBits) == 0);
+		}
+		if (found != 0) {
+			return true;
+		}
+	}
+	std::uint32_t found = 0;
+	for (; i < count; ++i) {
+		found |= static_cast<std::uint32_t>((masks[i] & forbiddenBits) == 0);
+	}
+	return found != 0;
+}
+
+#if SUBSET_SCAN_X86
+SUBSET_SCAN_TARGET("avx2")
+inline bool containsSubsetAvx2(std::uint32_t const* masks, std::size_t count, std::uint32_t forbiddenBits) {
+	__m256i const forbidden = _mm256_set1_epi32(static_cast<int>(forbiddenBits));
+	__m256i const zero = _mm256_setzero_si256();
+	std::size_t i = 0;
+	// 32 masks per round, the lanes are only checked once per round.
+	for (; i + 32 <= count; i += 32) {
+		__m256i const a = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(masks + i)), forbidden), zero);
+		__m256i const b = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(masks + i + 8)), forbidden), zero);
+		__m256i const c = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(masks + i + 16)), forbidden), zero);
+		__m256i const d = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(masks + i + 24)), forbidden), zero);
+		__m256i const any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+		if (!_mm256_testz_si256(any, any)) {
+			return true;
+		}
+	}
+	for (; i + 8 <= count; i += 8) {
+		__m256i const a = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(masks + i)), forbidden), zero);
+		if (!_mm256_testz_si256(a, a)) {
+			return true;
+		}
+	}
+	return containsSubsetScalar(masks + i, count - i, forbiddenBits);
+}
+
+SUBSET_SCAN_TARGET("avx512f")
+inline bool containsSubsetAvx512(std::uint32_t const* masks, std::size_t count, std::uint32_t forbiddenBits) {
+	__m512i const forbidden = _mm512_set1_epi32(static_cast<int>(forbiddenBits));
+	std::size_t i = 0;
+	// 64 masks per round, the lanes are only checked once per round.
+	for (; i + 64 <= count; i += 64) {
+		__mmask16 const a = _mm512_testn_epi32_mask(_mm512_loadu_si512(masks + i), forbidden);
+		__mmask16 const b = _mm512_testn_epi32_mask(_mm512_loadu_si512(masks + i + 16), forbidden);
+		__mmask16 const c = _mm512_testn_epi32_mask(_mm512_loadu_si512(masks + i + 32), forbidden);
+		__mmask16 const d = _mm512_testn_epi32_mask(_mm512_loadu_si512(masks + i + 48), forbidden);
+		if ((a | b | c | d) != 0) {
+			return true;
+		}
+	}
+	for (; i + 16 <= count; i += 16) {
+		if (_mm512_testn_epi32_mask(_mm512_loadu_si512(masks + i), forbidden) != 0) {
+			return true;
+		}
+	}
+	if (i < count) {
+		// Lanes beyond the end are neither loaded nor tested.
+		__mmask16 const tail = static_cast<__mmask16>((1u << (count - i)) - 1u);
+		return _mm512_mask_testn_epi32_mask(tail, _mm512_maskz_loadu_epi32(tail, masks + i), forbidden) != 0;
+	}
+	return false;
+}
+
+inline bool cpuSupportsAvx2() {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	__cpuid(info, 1);
+	bool const osSavesYmm = ((info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+	__cpuidex(info, 7, 0);
+	return osSavesYmm && ((info[1] & (1 << 5)) != 0);
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+inline bool cpuSupportsAvx512() {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	__cpuid(info, 1);
+	bool const osSavesZmm = ((info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 0xE6) == 0xE6);
+	__cpuidex(info, 7, 0);
+	return osSavesZmm && ((info[1] & (1 << 16)) != 0);
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx512f");
+#endif
+}
+#endif
+
+enum class SubsetScanKind {
+	SCALAR,
+	AVX2,
+	AVX512
+};
+
+inline SubsetScanKind detectSubsetScanKind() {
+#if SUBSET_SCAN_X86
+	if (cpuSupportsAvx512()) {
+		return SubsetScanKind::AVX512;
+	} else if (cpuSupportsAvx2()) {
+		return SubsetScanKind::AVX2;
+	}
+#endif
+	return SubsetScanKind::SCALAR;
+}
+
+inline SubsetScanFunction getSubsetScanFunction(SubsetScanKind const& kind) {
+	switch (kind) {
+#if SUBSET_SCAN_X86
+		case SubsetScanKind::AVX512:
+			return &containsSubsetAvx512;
+		case SubsetScanKind::AVX2:
+			return &containsSubsetAvx2;
+#endif
+		case SubsetScanKind::SCALAR:
+		default:
+			return &containsSubsetScalar;
+	}
+}
+
+inline char const* getSubsetScanName(SubsetScanKind const& kind) {
+	switch (kind) {
+		case SubsetScanKind::AVX512:
+			return "AVX-512";
+		case SubsetScanKind::AVX2:
+			return "AVX2";
+		case SubsetScanKind::SCALAR:
+		default:
+			return "scalar";
+	}
+}
+
+inline SubsetScanKind const subsetScanKind = detectSubsetScanKind();
+inline SubsetScanFunction const subsetScan = getSubsetScanFunction(subsetScanKind);
+
+#endif
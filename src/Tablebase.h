@@ -0,0 +1,232 @@
+#ifndef TABLEBASE_H_
+#define TABLEBASE_H_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "MemoryMapping.h"
+
+/*
+	The exact number of moves left for every stop cell and every set of presents left, in a memory mapped file with one byte per state.
+	Computed by retrograde analysis: a slide never brings presents back, so the sets are handled in increasing order. For each set, the slides collecting
+	a present lead to sets that are already done, and the ones collecting nothing stay within the set, which a BFS backwards over the predecessors with
+	all these starting values finishes.
+	The table only depends on the stop cell graph, so the file is named after its fingerprint and reused by every later run on the same board.
+	It has 2^PRESENT_COUNT * stopCellCount entries, the sets of presents left are the outer index, so each set is contiguous and the file is written front to back.
+*/
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+class Tablebase {
+public:
+	static constexpr std::uint32_t UNREACHABLE = std::numeric_limits<std::uint32_t>::max();
+	static constexpr std::uint8_t TABLE_UNREACHABLE = 0xFF;
+
+	Tablebase(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::string const& filename) : m_stopCellCount(board.getStopCellCount()), m_mapping(), m_entries(nullptr) {
+		// Only checked here, solveLayer() is also used for tables of fewer sets
+		static_assert(PRESENT_COUNT <= 40, "Tablebase has one entry per set of presents, which is too much for more than 40 presents.");
+		std::uint64_t const fingerprint = board.getFingerprint();
+		std::size_t const fileSize = HEADER_SIZE + getEntryCount();
+		if (std::filesystem::exists(filename) && (std::filesystem::file_size(filename) == fileSize)) {
+			m_mapping = MemoryMapping(filename, fileSize, false);
+			Header header;
+			std::memcpy(&header, m_mapping.getData(), sizeof(Header));
+			if ((header.magic == MAGIC) && (header.fingerprint == fingerprint) && (header.presentCount == PRESENT_COUNT) && (header.stopCellCount == m_stopCellCount)) {
+				m_entries = static_cast<std::uint8_t const*>(m_mapping.getData()) + HEADER_SIZE;
+				std::cout << "Tablebase: loaded " << getEntryCount() << " entries from '" << filename << "'." << std::endl;
+				return;
+			}
+			std::cerr << "The tablebase in '" << filename << "' does not belong to this board or is incomplete, rebuilding it." << std::endl;
+		}
+
+		auto const beginBuild = std::chrono::steady_clock::now();
+		{
+			MemoryMapping writableMapping(filename, fileSize, true);
+			build(board, static_cast<std::uint8_t*>(writableMapping.getData()) + HEADER_SIZE);
+			// The header goes last, so an interrupted build is never taken for a complete one
+			Header const header{ MAGIC, fingerprint, PRESENT_COUNT, m_stopCellCount };
+			std::memcpy(writableMapping.getData(), &header, sizeof(Header));
+		}
+		m_mapping = MemoryMapping(filename, fileSize, false);
+		m_entries = static_cast<std::uint8_t const*>(m_mapping.getData()) + HEADER_SIZE;
+		auto const endBuild = std::chrono::steady_clock::now();
+		std::cout << "Tablebase: built " << getEntryCount() << " entries in " << std::chrono::duration_cast<std::chrono::milliseconds>(endBuild - beginBuild).count() << " ms, saved to '" << filename << "'." << std::endl;
+	}
+	~Tablebase() {
+		//
+	}
+
+	// The file a board's tablebase is cached in, in the working directory.
+	static std::string getDefaultFilename(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board) {
+		std::stringstream filename;
+		filename << "tablebase_" << std::hex << std::setw(16) << std::setfill('0') << board.getFingerprint() << std::dec << ".bin";
+		return filename.str();
+	}
+
+	// The exact number of moves left, UNREACHABLE if the state can not be finished at all.
+	inline std::uint32_t getDistance(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		std::uint8_t const entry = m_entries[getIndex(stopCell, presentState.to_ullong())];
+		return (entry == TABLE_UNREACHABLE) ? UNREACHABLE : entry;
+	}
+
+	// Same interface as PresentDistances, the bound just happens to be exact.
+	inline std::uint32_t getLowerBound(std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		return getDistance(stopCell, presentState);
+	}
+
+	// A shortest solution from the state, empty if there is none.
+	std::string getMovesToTarget(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& presentState) const {
+		return followDistances(board, stopCell, presentState, [this](std::size_t const& cell, std::bitset<PRESENT_COUNT> const& state) { return getDistance(cell, state); });
+	}
+
+	/*
+		A shortest solution from the state, by always taking the first slide that lowers the distance by one, empty if there is none.
+		getDistanceOf(stopCell, presentState) has to return exact distances, UNREACHABLE for states that can not be finished.
+		Stops the program if no slide lowers the distance, as then the table is damaged.
+	*/
+	template<typename GET_DISTANCE>
+	static std::string followDistances(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::size_t stopCell, std::bitset<PRESENT_COUNT> presentState, GET_DISTANCE const& getDistanceOf) {
+		std::string result;
+		std::uint32_t distance = getDistanceOf(stopCell, presentState);
+		if (distance == UNREACHABLE) {
+			return result;
+		}
+		while (distance > 0) {
+			bool isLowered = false;
+			for (auto it = board.getStopCellEdgesBegin(stopCell); it != board.getStopCellEdgesEnd(stopCell); ++it) {
+				std::bitset<PRESENT_COUNT> const childState = presentState & it->keepMask;
+				if (getDistanceOf(it->target, childState) + 1 == distance) {
+					result.push_back(directionToChar(it->direction));
+					stopCell = it->target;
+					presentState = childState;
+					--distance;
+					isLowered = true;
+					break;
+				}
+			}
+			if (!isLowered) {
+				std::cerr << "No slide from stop cell " << stopCell << " lowers the distance of " << distance << " moves, the table is damaged!" << std::endl;
+				exit(-1);
+			}
+		}
+		return result;
+	}
+
+	inline std::size_t getEntryCount() const {
+		return (std::size_t(1) << PRESENT_COUNT) * m_stopCellCount;
+	}
+
+	/*
+		Fills layer with the entries of all stop cells for one set of presents, given the ones of all its subsets: childEntry(stopCell, presentState) has
+		to return the entry of any state with fewer presents. starts and queue are only scratch space, handed in to keep their allocations across calls.
+	*/
+	template<typename CHILD_ENTRY>
+	static void solveLayer(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::bitset<PRESENT_COUNT> const& presents, std::uint8_t* layer, CHILD_ENTRY const& childEntry, std::vector<std::pair<std::uint8_t, std::uint32_t>>& starts, std::vector<std::pair<std::uint8_t, std::uint32_t>>& queue) {
+		std::size_t const stopCellCount = board.getStopCellCount();
+		// The states of the set with their starting values, sorted, and the ones lowered by the BFS, which are appended in increasing order
+		std::array<std::size_t, 257> counts;
+		counts.fill(0);
+		for (std::size_t stopCell = 0; stopCell < stopCellCount; ++stopCell) {
+			std::uint32_t best = TABLE_UNREACHABLE;
+			if (board.isTargetStopCell(stopCell)) {
+				best = presents.none() ? 0 : TABLE_UNREACHABLE;
+			} else {
+				for (auto it = board.getStopCellEdgesBegin(stopCell); it != board.getStopCellEdgesEnd(stopCell); ++it) {
+					std::bitset<PRESENT_COUNT> const childState = presents & it->keepMask;
+					if (childState != presents) {
+						std::uint8_t const entry = childEntry(it->target, childState);
+						if (entry != TABLE_UNREACHABLE) {
+							best = std::min<std::uint32_t>(best, checkDistance(entry + 1));
+						}
+					}
+				}
+			}
+			layer[stopCell] = static_cast<std::uint8_t>(best);
+			++counts[layer[stopCell] + 1];
+		}
+
+		// Counting sort of the starting values, unreachable ones are never a start
+		for (std::size_t i = 1; i < counts.size(); ++i) {
+			counts[i] += counts[i - 1];
+		}
+		starts.resize(counts[TABLE_UNREACHABLE]);
+		for (std::size_t stopCell = 0; stopCell < stopCellCount; ++stopCell) {
+			if (layer[stopCell] != TABLE_UNREACHABLE) {
+				starts[counts[layer[stopCell]]++] = std::make_pair(layer[stopCell], static_cast<std::uint32_t>(stopCell));
+			}
+		}
+
+		// Unit weights, so merging the sorted starts with the FIFO queue handles the states by increasing distance
+		queue.clear();
+		std::size_t startHead = 0;
+		std::size_t queueHead = 0;
+		while ((startHead < starts.size()) || (queueHead < queue.size())) {
+			bool const isFromStarts = (queueHead == queue.size()) || ((startHead < starts.size()) && (starts[startHead].first <= queue[queueHead].first));
+			std::pair<std::uint8_t, std::uint32_t> const current = isFromStarts ? starts[startHead++] : queue[queueHead++];
+			if (layer[current.second] != current.first) {
+				continue;
+			}
+			std::uint32_t const distance = current.first + 1;
+			for (auto it = board.getStopCellPredecessorsBegin(current.second); it != board.getStopCellPredecessorsEnd(current.second); ++it) {
+				if (((presents & it->keepMask) == presents) && (distance < layer[it->origin])) {
+					layer[it->origin] = static_cast<std::uint8_t>(checkDistance(distance));
+					queue.push_back(std::make_pair(layer[it->origin], it->origin));
+				}
+			}
+		}
+	}
+private:
+	struct Header {
+		std::uint64_t magic;
+		std::uint64_t fingerprint;
+		std::uint64_t presentCount;
+		std::uint64_t stopCellCount;
+	};
+	static constexpr std::uint64_t MAGIC = 0x3130425447504354ull; // "TCPGTB01"
+	// The entries start on their own cache line
+	static constexpr std::size_t HEADER_SIZE = 64;
+
+	inline std::size_t getIndex(std::size_t const& stopCell, std::uint64_t const& presentState) const {
+		return static_cast<std::size_t>(presentState) * m_stopCellCount + stopCell;
+	}
+
+	static inline std::uint32_t checkDistance(std::uint32_t const& distance) {
+		if (distance >= TABLE_UNREACHABLE) {
+			std::cerr << "The tablebase stores at most " << (TABLE_UNREACHABLE - 1) << " moves per state, this board needs more!" << std::endl;
+			exit(-1);
+		}
+		return distance;
+	}
+
+	void build(Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT> const& board, std::uint8_t* entries) const {
+		std::uint64_t const presentStateCount = std::uint64_t(1) << PRESENT_COUNT;
+		std::vector<std::pair<std::uint8_t, std::uint32_t>> starts;
+		std::vector<std::pair<std::uint8_t, std::uint32_t>> queue;
+		auto const childEntry = [this, entries](std::size_t const& stopCell, std::bitset<PRESENT_COUNT> const& childState) {
+			return entries[getIndex(stopCell, childState.to_ullong())];
+		};
+
+		for (std::uint64_t presentState = 0; presentState < presentStateCount; ++presentState) {
+			solveLayer(board, std::bitset<PRESENT_COUNT>(presentState), entries + getIndex(0, presentState), childEntry, starts, queue);
+			if ((presentState & 0xFFFFF) == 0xFFFFF) {
+				std::cout << "Tablebase: " << (presentState + 1) << " of " << presentStateCount << " sets of presents done." << std::endl;
+			}
+		}
+	}
+
+	std::size_t const m_stopCellCount;
+	MemoryMapping m_mapping;
+	std::uint8_t const* m_entries;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef TRANSPOSITIONTABLE_H_
+#define TRANSPOSITIONTABLE_H_
+
+#include <cstdint>
+
+#include "BucketHashing.h"
+#include "MemoryMapping.h"
+
+/*
+	A fixed-size hash table from packed search states to a learned lower bound on their remaining moves, for depth-first searches like IDA*.
+	Entries are grouped into buckets of one cache line, a state can only be stored in the bucket its key hashes to.
+	When a bucket is full, the entry with the smallest bound is replaced, as it took the least work to learn.
+	A bound of 0 marks an empty entry, so states without any remaining moves are never stored.
+*/
+class TranspositionTable {
+public:
+	static constexpr std::size_t BUCKET_SIZE = 4;
+
+	explicit TranspositionTable(std::uint64_t const& byteCount) : m_bucketCount(getBucketCount(byteCount, sizeof(Bucket))), m_mapping(m_bucketCount * sizeof(Bucket)), m_buckets(static_cast<Bucket*>(m_mapping.getData())), m_entryCount(0) {
+		//
+	}
+	~TranspositionTable() {
+		//
+	}
+
+	// The stored bound for the state, 0 if it is not known.
+	inline std::uint32_t getBound(std::uint64_t const& key) const {
+		Bucket const& bucket = m_buckets[getBucketIndex(key, m_bucketCount)];
+		for (std::size_t i = 0; i < BUCKET_SIZE; ++i) {
+			if ((bucket.bounds[i] != 0) && (bucket.keys[i] == key)) {
+				return bucket.bounds[i];
+			}
+		}
+		return 0;
+	}
+
+	inline void storeBound(std::uint64_t const& key, std::uint32_t const& bound) {
+		if (bound == 0) {
+			return;
+		}
+		Bucket& bucket = m_buckets[getBucketIndex(key, m_bucketCount)];
+		std::size_t slot = 0;
+		for (std::size_t i = 0; i < BUCKET_SIZE; ++i) {
+			if ((bucket.bounds[i] != 0) && (bucket.keys[i] == key)) {
+				if (bound > bucket.bounds[i]) {
+					bucket.bounds[i] = bound;
+				}
+				return;
+			}
+			if (bucket.bounds[i] < bucket.bounds[slot]) {
+				slot = i;
+			}
+		}
+		if (bucket.bounds[slot] == 0) {
+			++m_entryCount;
+		}
+		bucket.keys[slot] = key;
+		bucket.bounds[slot] = bound;
+	}
+
+	inline std::size_t getEntryCount() const {
+		return m_entryCount;
+	}
+
+	inline std::size_t getCapacity() const {
+		return m_bucketCount * BUCKET_SIZE;
+	}
+private:
+	struct Bucket {
+		std::uint64_t keys[BUCKET_SIZE];
+		std::uint32_t bounds[BUCKET_SIZE];
+		std::uint32_t padding[BUCKET_SIZE];
+	};
+	static_assert(sizeof(Bucket) == 64, "A bucket should fill exactly one cache line.");
+
+	std::size_t const m_bucketCount;
+	MemoryMapping m_mapping;
+	Bucket* m_buckets;
+	std::size_t m_entryCount;
+};
+
+#endif
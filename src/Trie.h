@@ -1,17 +1,23 @@
 #ifndef TRIE_H_
 #define TRIE_H_
 
+#include <array>
 #include <bitset>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
 #include <vector>
 
 struct TrieNode {
 public:
-	TrieNode() : zeroChild(-1), oneChild(-1) {
+	TrieNode() : zeroChild(0), oneChild(0) {
 		//
 	}
 
-	std::int64_t zeroChild;
-	std::int64_t oneChild;
+	// Indices into the node pool of the owning Trie. The root (index 0) is never a child, so 0 means "no child".
+	std::uint32_t zeroChild;
+	std::uint32_t oneChild;
 
 	template<class Archive>
 	void serialize(Archive& archive) {
@@ -22,7 +28,12 @@ public:
 template <std::size_t BIT_COUNT>
 class Trie {
 public:
-	Trie() : m_nodes() {
+	// The name of --visited, also written to state backups, see play()
+	static std::string getName() {
+		return "trie";
+	}
+
+	Trie() : m_nodes(), m_freeListHead(0) {
 		//
 	}
 	~Trie() {
@@ -35,9 +46,39 @@ public:
 		}
 		if constexpr(BIT_COUNT == 0) {
 			return true;
+		} else {
+			// Depth-first walk with an explicit stack. Only a one-bit in the value can open a second branch, so there is at most one pending branch per level.
+			std::array<PendingBranch, BIT_COUNT> stack;
+			std::size_t stackSize = 0;
+			std::uint32_t nodeIndex = 0;
+			std::size_t i = 0;
+			while (true) {
+				while (i < BIT_COUNT) {
+					TrieNode const& node = m_nodes[nodeIndex];
+					std::uint32_t const oneChild = value[i] ? node.oneChild : 0;
+					if (node.zeroChild != 0) {
+						if (oneChild != 0) {
+							stack[stackSize++] = PendingBranch(oneChild, i + 1);
+						}
+						nodeIndex = node.zeroChild;
+					} else if (oneChild != 0) {
+						nodeIndex = oneChild;
+					} else {
+						break;
+					}
+					++i;
+				}
+				if (i >= BIT_COUNT) {
+					return true;
+				}
+				if (stackSize == 0) {
+					return false;
+				}
+				--stackSize;
+				nodeIndex = stack[stackSize].nodeIndex;
+				i = stack[stackSize].level;
+			}
 		}
-
-		return checkNodeHasValueOrSubsetThereof(0, value, 0);
 	}
 
 	void insertValue(std::bitset<BIT_COUNT> const& value) {
@@ -48,52 +89,105 @@ public:
 			return;
 		}
 
-		std::int64_t nodeIndex = 0;
+		std::uint32_t nodeIndex = 0;
 		for (std::size_t i = 0; i < BIT_COUNT; ++i) {
 			auto const bit = value[i];
 			if (!bit) {
-				if (m_nodes[nodeIndex].zeroChild < 0) {
-					m_nodes[nodeIndex].zeroChild = makeNode();
+				if (m_nodes[nodeIndex].zeroChild == 0) {
+					std::uint32_t const child = makeNode();
+					m_nodes[nodeIndex].zeroChild = child;
 				}
 				nodeIndex = m_nodes[nodeIndex].zeroChild;
 			} else {
-				if (m_nodes[nodeIndex].oneChild < 0) {
-					m_nodes[nodeIndex].oneChild = makeNode();
+				if (m_nodes[nodeIndex].oneChild == 0) {
+					std::uint32_t const child = makeNode();
+					m_nodes[nodeIndex].oneChild = child;
 				}
 				nodeIndex = m_nodes[nodeIndex].oneChild;
 			}
 		}
 	}
 
+	/*
+		Inserts the value and removes all stored supersets of it, as every query they answer is answered by the new value as well.
+		Nodes that become unused are reclaimed for later inserts, so the trie only ever holds a minimal antichain.
+	*/
+	void insertValueEvictingSupersets(std::bitset<BIT_COUNT> const& value) {
+		if constexpr(BIT_COUNT > 0) {
+			if (m_nodes.size() > 0) {
+				removeSupersets(0, value, 0);
+			}
+		}
+		insertValue(value);
+	}
+
 	template<class Archive>
 	void serialize(Archive& archive) {
-		archive(m_nodes);
+		archive(m_nodes, m_freeListHead);
 	}
 private:
-	inline std::int64_t makeNode() {
-		std::int64_t const result = m_nodes.size();
+	struct PendingBranch {
+	public:
+		PendingBranch() : nodeIndex(0), level(0) {
+			//
+		}
+		PendingBranch(std::uint32_t const& nodeIndex, std::size_t const& level) : nodeIndex(nodeIndex), level(level) {
+			//
+		}
+
+		std::uint32_t nodeIndex;
+		std::size_t level;
+	};
+
+	inline std::uint32_t makeNode() {
+		if (m_freeListHead != 0) {
+			std::uint32_t const result = m_freeListHead;
+			m_freeListHead = m_nodes[result].zeroChild;
+			m_nodes[result] = TrieNode();
+			return result;
+		}
+		if (m_nodes.size() >= std::numeric_limits<std::uint32_t>::max()) {
+			std::cerr << "Internal Error: Trie node pool exhausted, can not address more than 2^32 nodes." << std::endl;
+			exit(-1);
+		}
+		std::uint32_t const result = static_cast<std::uint32_t>(m_nodes.size());
 		m_nodes.push_back(TrieNode());
 		return result;
 	}
 
-	bool checkNodeHasValueOrSubsetThereof(std::int64_t const& nodeIndex, std::bitset<BIT_COUNT> const& value, std::size_t i) const {
+	inline void freeNode(std::uint32_t const& nodeIndex) {
+		m_nodes[nodeIndex].zeroChild = m_freeListHead;
+		m_nodes[nodeIndex].oneChild = 0;
+		m_freeListHead = nodeIndex;
+	}
+
+	// Returns true if the node at nodeIndex no longer leads to any value and can be freed by its parent.
+	bool removeSupersets(std::uint32_t const& nodeIndex, std::bitset<BIT_COUNT> const& value, std::size_t i) {
 		if (i >= BIT_COUNT) {
 			return true;
 		}
 
-		auto const bit = value[i];
-		if (m_nodes[nodeIndex].zeroChild >= 0) {
-			if (checkNodeHasValueOrSubsetThereof(m_nodes[nodeIndex].zeroChild, value, i + 1)) {
-				return true;
+		// A superset has to have a one wherever the value has one, but may have either where the value has a zero.
+		if (!value[i] && (m_nodes[nodeIndex].zeroChild != 0)) {
+			std::uint32_t const child = m_nodes[nodeIndex].zeroChild;
+			if (removeSupersets(child, value, i + 1)) {
+				freeNode(child);
+				m_nodes[nodeIndex].zeroChild = 0;
 			}
 		}
-		if (bit && (m_nodes[nodeIndex].oneChild >= 0)) {
-			return checkNodeHasValueOrSubsetThereof(m_nodes[nodeIndex].oneChild, value, i + 1);
+		if (m_nodes[nodeIndex].oneChild != 0) {
+			std::uint32_t const child = m_nodes[nodeIndex].oneChild;
+			if (removeSupersets(child, value, i + 1)) {
+				freeNode(child);
+				m_nodes[nodeIndex].oneChild = 0;
+			}
 		}
-		return false;
+		return (m_nodes[nodeIndex].zeroChild == 0) && (m_nodes[nodeIndex].oneChild == 0);
 	}
 
 	std::vector<TrieNode> m_nodes;
+	// First node of the list of reclaimed nodes, linked through zeroChild. 0 if there are none.
+	std::uint32_t m_freeListHead;
 };
 
 #endif
@@ -0,0 +1,86 @@
+#ifndef WORKSTEALINGDEQUE_H_
+#define WORKSTEALINGDEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/*
+	The Chase-Lev work-stealing deque, in the formulation for the C11 memory model by Le, Pop, Cohen and Zappa Nardelli (2013).
+	Only the owning thread may push and pop at the bottom, any thread may steal from the top.
+	The capacity is fixed, a push to a full deque fails and the owner has to handle the element itself.
+	T has to be a pointer, nullptr means that nothing was taken.
+*/
+template <typename T>
+class WorkStealingDeque {
+public:
+	explicit WorkStealingDeque(std::size_t const& capacityBits) : m_mask((std::int64_t(1) << capacityBits) - 1), m_top(0), m_bottom(0), m_buffer(std::size_t(1) << capacityBits) {
+		//
+	}
+	WorkStealingDeque(WorkStealingDeque const& other) = delete;
+	WorkStealingDeque& operator=(WorkStealingDeque const& other) = delete;
+	~WorkStealingDeque() {
+		//
+	}
+
+	// Owner only.
+	bool push(T const& value) {
+		std::int64_t const bottom = m_bottom.load(std::memory_order_relaxed);
+		std::int64_t const top = m_top.load(std::memory_order_acquire);
+		if (bottom - top > m_mask) {
+			return false;
+		}
+		m_buffer[bottom & m_mask].store(value, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Owner only, takes the element pushed last.
+	T pop() {
+		std::int64_t const bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t top = m_top.load(std::memory_order_relaxed);
+		if (top > bottom) {
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		T result = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+		if (top == bottom) {
+			// The last element, a thief may be taking it at the same time
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				result = nullptr;
+			}
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	// Any thread, takes the element pushed first. Also returns nullptr if another thread won the race for it.
+	T steal() {
+		std::int64_t top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t const bottom = m_bottom.load(std::memory_order_acquire);
+		if (top >= bottom) {
+			return nullptr;
+		}
+		T const result = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return nullptr;
+		}
+		return result;
+	}
+
+	// Owner only, exact for the owner up to concurrent steals.
+	bool empty() const {
+		return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+	}
+private:
+	std::int64_t const m_mask;
+	alignas(64) std::atomic<std::int64_t> m_top;
+	alignas(64) std::atomic<std::int64_t> m_bottom;
+	std::vector<std::atomic<T>> m_buffer;
+};
+
+#endif
@@ -0,0 +1,359 @@
+#ifndef ZDDSET_H_
+#define ZDDSET_H_
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*
+	Shared node store of all ZddSets with the same BIT_COUNT.
+	A family of sets is a zero-suppressed decision diagram: every node tests one variable (bit index), variables increase towards the terminals,
+	the "lo" edge leads to the sets without the variable, the "hi" edge to the sets with it, and nodes with an empty "hi" family are never created.
+	Nodes are hash-consed in a unique table, so isomorphic subgraphs are stored once, within a family as well as across families.
+	Nodes are reference counted by their parents and the owning ZddSets, and reclaimed as soon as they are no longer used.
+*/
+template <std::size_t BIT_COUNT>
+class ZddManager {
+public:
+	static_assert(BIT_COUNT <= 64, "ZddManager supports at most 64 bits.");
+
+	// The empty family and the family only containing the empty set.
+	static constexpr std::uint32_t EMPTY = 0;
+	static constexpr std::uint32_t BASE = 1;
+
+	ZddManager() : m_nodes(2), m_table(INITIAL_TABLE_SIZE, 0), m_tableCount(0), m_freeListHead(0) {
+		//
+	}
+	~ZddManager() {
+		//
+	}
+
+	// Whether the family contains a subset of the given set.
+	bool containsSubsetOf(std::uint32_t family, std::uint64_t const& bits) const {
+		// Only a one-bit in the value can open a second branch, so there is at most one pending branch per variable.
+		std::array<std::uint32_t, BIT_COUNT + 1> stack;
+		std::size_t stackSize = 0;
+		while (true) {
+			while (family > BASE) {
+				ZddNode const& node = m_nodes[family];
+				if (((bits >> node.variable) & 1u) != 0) {
+					stack[stackSize++] = node.hi;
+				}
+				family = node.lo;
+			}
+			if (family == BASE) {
+				return true;
+			}
+			if (stackSize == 0) {
+				return false;
+			}
+			family = stack[--stackSize];
+		}
+	}
+
+	// Returns the family with the given set added. Only nodes on the path of the set are rebuilt.
+	std::uint32_t insert(std::uint32_t const& family, std::uint64_t const& bits) {
+		std::size_t const variable = getVariable(family);
+		std::size_t const lowestBit = getLowestBit(bits);
+		if (variable < lowestBit) {
+			ZddNode const node = m_nodes[family];
+			return makeNode(variable, insert(node.lo, bits), node.hi);
+		} else if (variable == lowestBit) {
+			if (variable == BIT_COUNT) {
+				return BASE;
+			}
+			ZddNode const node = m_nodes[family];
+			return makeNode(variable, node.lo, insert(node.hi, bits & (bits - 1)));
+		}
+		return makeNode(lowestBit, family, insert(EMPTY, bits & (bits - 1)));
+	}
+
+	// Returns the family without all supersets of the given set.
+	std::uint32_t removeSupersets(std::uint32_t const& family, std::uint64_t const& bits) {
+		if ((family == EMPTY) || (bits == 0)) {
+			return EMPTY;
+		} else if (family == BASE) {
+			return BASE;
+		}
+		ZddNode const node = m_nodes[family];
+		std::size_t const lowestBit = getLowestBit(bits);
+		if (node.variable > lowestBit) {
+			// No set in here contains the lowest bit.
+			return family;
+		} else if (node.variable < lowestBit) {
+			return makeNode(node.variable, removeSupersets(node.lo, bits), removeSupersets(node.hi, bits));
+		}
+		return makeNode(node.variable, node.lo, removeSupersets(node.hi, bits & (bits - 1)));
+	}
+
+	void getSets(std::uint32_t const& family, std::uint64_t const& prefix, std::vector<std::uint64_t>& result) const {
+		if (family == BASE) {
+			result.push_back(prefix);
+		} else if (family != EMPTY) {
+			ZddNode const& node = m_nodes[family];
+			getSets(node.lo, prefix, result);
+			getSets(node.hi, prefix | (std::uint64_t(1) << node.variable), result);
+		}
+	}
+
+	inline void reference(std::uint32_t const& family) {
+		if (family > BASE) {
+			++m_nodes[family].referenceCount;
+		}
+	}
+
+	inline void release(std::uint32_t const& family) {
+		if (family > BASE) {
+			if (--m_nodes[family].referenceCount == 0) {
+				freeNode(family);
+			}
+		}
+	}
+
+	// Frees the result of an operation that ended up not being used.
+	inline void releaseIfUnreferenced(std::uint32_t const& family) {
+		if ((family > BASE) && (m_nodes[family].referenceCount == 0)) {
+			freeNode(family);
+		}
+	}
+
+	std::size_t getNodeCount() const {
+		return m_tableCount;
+	}
+private:
+	static constexpr std::size_t INITIAL_TABLE_SIZE = 1024;
+
+	struct ZddNode {
+	public:
+		ZddNode() : variable(0), lo(EMPTY), hi(EMPTY), referenceCount(0) {
+			//
+		}
+		ZddNode(std::uint32_t const& variable, std::uint32_t const& lo, std::uint32_t const& hi) : variable(variable), lo(lo), hi(hi), referenceCount(0) {
+			//
+		}
+
+		std::uint32_t variable;
+		std::uint32_t lo;
+		std::uint32_t hi;
+		std::uint32_t referenceCount;
+	};
+
+	static inline std::size_t getLowestBit(std::uint64_t const& bits) {
+		if (bits == 0) {
+			return BIT_COUNT;
+		}
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return static_cast<std::size_t>(index);
+#else
+		return static_cast<std::size_t>(__builtin_ctzll(bits));
+#endif
+	}
+
+	inline std::size_t getVariable(std::uint32_t const& family) const {
+		return (family <= BASE) ? BIT_COUNT : m_nodes[family].variable;
+	}
+
+	static inline std::size_t hashNode(std::uint32_t const& variable, std::uint32_t const& lo, std::uint32_t const& hi) {
+		std::uint64_t h = (static_cast<std::uint64_t>(lo) << 32) | hi;
+		h ^= static_cast<std::uint64_t>(variable) * 0x9E3779B97F4A7C15ull;
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDull;
+		h ^= h >> 33;
+		return static_cast<std::size_t>(h);
+	}
+
+	inline std::size_t getHomeSlot(std::uint32_t const& nodeIndex) const {
+		ZddNode const& node = m_nodes[nodeIndex];
+		return hashNode(node.variable, node.lo, node.hi) & (m_table.size() - 1);
+	}
+
+	std::uint32_t makeNode(std::size_t const& variable, std::uint32_t const& lo, std::uint32_t const& hi) {
+		if (hi == EMPTY) {
+			return lo;
+		}
+		std::size_t const mask = m_table.size() - 1;
+		std::size_t slot = hashNode(static_cast<std::uint32_t>(variable), lo, hi) & mask;
+		while (m_table[slot] != 0) {
+			ZddNode const& node = m_nodes[m_table[slot]];
+			if ((node.variable == variable) && (node.lo == lo) && (node.hi == hi)) {
+				return m_table[slot];
+			}
+			slot = (slot + 1) & mask;
+		}
+
+		std::uint32_t result;
+		if (m_freeListHead != 0) {
+			result = m_freeListHead;
+			m_freeListHead = m_nodes[result].lo;
+		} else {
+			if (m_nodes.size() >= std::numeric_limits<std::uint32_t>::max()) {
+				std::cerr << "Internal Error: ZDD node pool exhausted, can not address more than 2^32 nodes." << std::endl;
+				exit(-1);
+			}
+			result = static_cast<std::uint32_t>(m_nodes.size());
+			m_nodes.push_back(ZddNode());
+		}
+		m_nodes[result] = ZddNode(static_cast<std::uint32_t>(variable), lo, hi);
+		reference(lo);
+		reference(hi);
+
+		m_table[slot] = result;
+		++m_tableCount;
+		if (m_tableCount * 2 > m_table.size()) {
+			resizeTable(m_table.size() * 2);
+		}
+		return result;
+	}
+
+	void freeNode(std::uint32_t const& nodeIndex) {
+		removeFromTable(nodeIndex);
+		std::uint32_t const lo = m_nodes[nodeIndex].lo;
+		std::uint32_t const hi = m_nodes[nodeIndex].hi;
+		m_nodes[nodeIndex].lo = m_freeListHead;
+		m_nodes[nodeIndex].hi = EMPTY;
+		m_freeListHead = nodeIndex;
+		release(lo);
+		release(hi);
+	}
+
+	// Linear probing with backward shift deletion, so lookups never have to skip tombstones.
+	void removeFromTable(std::uint32_t const& nodeIndex) {
+		std::size_t const mask = m_table.size() - 1;
+		std::size_t slot = getHomeSlot(nodeIndex);
+		while (m_table[slot] != nodeIndex) {
+			slot = (slot + 1) & mask;
+		}
+		std::size_t next = slot;
+		while (true) {
+			next = (next + 1) & mask;
+			if (m_table[next] == 0) {
+				break;
+			}
+			std::size_t const home = getHomeSlot(m_table[next]);
+			// Move the entry into the hole unless its home lies cyclically in (slot, next].
+			bool const homeInRange = (slot <= next) ? ((slot < home) && (home <= next)) : ((slot < home) || (home <= next));
+			if (!homeInRange) {
+				m_table[slot] = m_table[next];
+				slot = next;
+			}
+		}
+		m_table[slot] = 0;
+		--m_tableCount;
+	}
+
+	void resizeTable(std::size_t const& newSize) {
+		std::vector<std::uint32_t> oldTable(newSize, 0);
+		oldTable.swap(m_table);
+		std::size_t const mask = m_table.size() - 1;
+		for (auto it = oldTable.cbegin(); it != oldTable.cend(); ++it) {
+			if (*it != 0) {
+				std::size_t slot = getHomeSlot(*it);
+				while (m_table[slot] != 0) {
+					slot = (slot + 1) & mask;
+				}
+				m_table[slot] = *it;
+			}
+		}
+	}
+
+	std::vector<ZddNode> m_nodes;
+	// Open addressing over node indices, 0 marks an empty slot as the terminals are never stored.
+	std::vector<std::uint32_t> m_table;
+	std::size_t m_tableCount;
+	// First node of the list of reclaimed nodes, linked through lo. 0 if there are none.
+	std::uint32_t m_freeListHead;
+};
+
+/*
+	Same interface as Trie, but stores the family as a root in the ZddManager shared by all ZddSets of this BIT_COUNT.
+	As all instances modify the same manager, they must not be modified concurrently, not even different instances.
+*/
+template <std::size_t BIT_COUNT>
+class ZddSet {
+public:
+	static constexpr bool SHARES_STATE_ACROSS_INSTANCES = true;
+
+	// The name of --visited, also written to state backups, see play()
+	static std::string getName() {
+		return "zdd";
+	}
+
+	ZddSet() : m_root(ZddManager<BIT_COUNT>::EMPTY) {
+		//
+	}
+	ZddSet(ZddSet const& other) : m_root(other.m_root) {
+		s_manager.reference(m_root);
+	}
+	ZddSet& operator=(ZddSet const& other) {
+		setRoot(other.m_root);
+		return *this;
+	}
+	~ZddSet() {
+		s_manager.release(m_root);
+	}
+
+	bool hasValueOrSubsetThereof(std::bitset<BIT_COUNT> const& value) const {
+		return s_manager.containsSubsetOf(m_root, value.to_ullong());
+	}
+
+	void insertValue(std::bitset<BIT_COUNT> const& value) {
+		setRoot(s_manager.insert(m_root, value.to_ullong()));
+	}
+
+	/*
+		Inserts the value and removes all stored supersets of it, see Trie.
+	*/
+	void insertValueEvictingSupersets(std::bitset<BIT_COUNT> const& value) {
+		std::uint64_t const bits = value.to_ullong();
+		std::uint32_t const evicted = s_manager.removeSupersets(m_root, bits);
+		std::uint32_t const newRoot = s_manager.insert(evicted, bits);
+		s_manager.reference(newRoot);
+		s_manager.releaseIfUnreferenced(evicted);
+		s_manager.release(m_root);
+		m_root = newRoot;
+	}
+
+	// The node indices are only meaningful within this process, so the family is stored as its list of sets.
+	template<class Archive>
+	void save(Archive& archive) const {
+		std::vector<std::uint64_t> sets;
+		s_manager.getSets(m_root, 0, sets);
+		archive(sets);
+	}
+
+	template<class Archive>
+	void load(Archive& archive) {
+		std::vector<std::uint64_t> sets;
+		archive(sets);
+		setRoot(ZddManager<BIT_COUNT>::EMPTY);
+		for (auto it = sets.cbegin(); it != sets.cend(); ++it) {
+			insertValue(std::bitset<BIT_COUNT>(*it));
+		}
+	}
+
+	static std::size_t getNodeCount() {
+		return s_manager.getNodeCount();
+	}
+private:
+	inline void setRoot(std::uint32_t const& newRoot) {
+		s_manager.reference(newRoot);
+		s_manager.release(m_root);
+		m_root = newRoot;
+	}
+
+	std::uint32_t m_root;
+
+	static inline ZddManager<BIT_COUNT> s_manager;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include <array>
 #include <bitset>
 #include <chrono>
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <list>
@@ -11,93 +12,33 @@
 #include <queue>
 
 #include <cereal/cereal.hpp>
+#include <cereal/types/array.hpp>
 #include <cereal/types/bitset.hpp>
 #include <cereal/types/string.hpp>
 #include <cereal/types/queue.hpp>
 #include <cereal/types/vector.hpp>
 #include <cereal/archives/binary.hpp>
 
+#include "AntichainSet.h"
 #include "Board.h"
-#include "QueueObject.h"
+#include "Boards.h"
+#include "DenseVisitedSet.h"
+#include "PredecessorLog.h"
 #include "PlayTest.h"
 #include "Play.h"
+#include "PlayAStar.h"
+#include "PlayBeam.h"
+#include "PlayBidirectional.h"
+#include "PlayBranchAndBound.h"
+#include "PlayIdaStar.h"
+#include "PlayMeetInTheMiddle.h"
+#include "PlayNonOptimal.h"
+#include "PlayTablebase.h"
+#include "SearchOptions.h"
+#include "StrideTrie.h"
+#include "SubsetScan.h"
 #include "Trie.h"
-
-static const std::array<std::string, 20> fieldStringBasic = {
-	"####################", 
-	"#   # # #          #", 
-	"#      ###  #     O#", 
-	"#       #   #  #   #", 
-	"##  # #  # #       #", 
-	"#       #    #   ###", 
-	"#      # #  #      #", 
-	"##      #       ## #", 
-	"#    ### ### ## #  #", 
-	"#    #P #          #", 
-	"# O               ##", 
-	"#       #          #", 
-	"#        # #       #", 
-	"#   #   #   #    # #", 
-	"#    #   #  #  #   #", 
-	"#  #    #      ## ##", 
-	"#     #  #    ##   #", 
-	"#     # # #        X", 
-	"# #  ##    #    #  #", 
-	"####################"
-};
-static const std::vector<std::pair<std::size_t, std::size_t>> holeConnectionsBasic = {
-	{58, 202},
-	{202, 58}
-};
-
-static const std::array<std::string, 40> fieldStringChristmas = {
-	"TT T#T   #T#T#T#T #   T #T#  #TT  #T$  #",
-	"T     #     $                          T",
-	"T       $  T TT  TT##T#TT   T  T  T  T  ",
-	"   T     T   T  T         T$            ",
-	"#T     T   O   T$TT##TTTT   TT T        ",
-	"  $ T                           T   T   ",
-	"#                TT#TTTTT$             T",
-	"     T  T    TT$                  T$    ",
-	" T          T$   T#TT#T#T  T#          #",
-	"        T    T T         #      T      O",
-	"# T     #    T   T##TTTT# T T      T#T $",
-	"    T T              P         # $     #",
-	"#          TT    T##T#TTT T   T    T T #",
-	"     TTT   T   T       $     #   T   T T",
-	"T  #$        T  #T###TT#T T TT          ",
-	"   ## T   T     T        T T        T T#",
-	"  #T        #  T#T##TT#T#  T T    T     ",
-	"T T  T T T  #                # TT T    #",
-	"     T   #   T   TT#TTTTT T# T       T  ",
-	"T  T       #  #     $           T   TTT ",
-	"   T  T      T  #T##TTT## T  T#     T   ",
-	"#   T    T    T T        TTT  T TT     T",
-	"$T  #T    T    T TT#TT### T  T        T ",
-	"# T T#    T #T            TT   T T T    ",
-	"#        T  $    T###T#TT            T  ",
-	"   T T        T        #  T     T    TT ",
-	"T T T  ##   T T  T  T  T$T    T  T T  $ ",
-	"   TT  T      T T $# T T   TT        T T",
-	"      #TT  T                T    #     T",
-	"  T        TTT T T T  T#T           T  T",
-	"T  T    T      T             T T      TT",
-	"#T   T        T  T TT # TT  TT  #      #",
-	"#   T    ##    $   TT    #  #  T# T     ",
-	" T     T     T TT TT#T      T   T       ",
-	" # T              T T   T  #T T #  TT T#",
-	"T  T      T T #    T  T   $            T",
-	"T      TT       #        # #  T       TT",
-	"# T         T      T          # T  T   #",
-	"T$ O           T     T     T    T      X",
-	" T #   # T    #T# #  ##   T  T  $ # #TTT"
-};
-
-static const std::vector<std::pair<std::size_t, std::size_t>> holeConnectionsChristmas = {
-	{399, 1523},
-	{1523, 171},
-	{171, 399}
-};
+#include "ZddSet.h"
 
 enum class PlayMode {
 	MODE_CLASSIC,
@@ -108,10 +49,152 @@ void printHelp() {
 	std::cerr << "Options:" << std::endl;
 	std::cerr << "--classic: Play the game as presented in 19/2023." << std::endl;
 	std::cerr << "--christmas: Play the game as presented in 28/2023." << std::endl;
-	std::cerr << "--play [TURNS STRING]: Play the given turns in the selected game mode." << std::endl;
+	std::cerr << "--play [TURNS STRING]: Play the given turns in the selected game mode. With --engine tablebase, finish the position they lead to in the shortest way." << std::endl;
 	std::cerr << "--fromBackup [FILENAME]: Loads the given file as a state backup and resumes operation from there." << std::endl;
 	std::cerr << "--noBackups: Disable creation of state backups. Useful for keeping disk usage in check." << std::endl;
 	std::cerr << "--deleteOldBackups: Whether to delete the preceeding state backup file when a new one has been written. Useful for keeping disk usage in check." << std::endl;
+	std::cerr << "--threads [N]: Expand the search queue using N threads. The result is the same as with a single thread." << std::endl;
+	std::cerr << "--visited [auto|dense|antichain|trie|stride2|stride4|zdd]: The structure used for remembering visited states per cell. 'auto' (default) uses the one of the state backup given by --fromBackup, otherwise 'dense' if it fits into the memory given by --denseMemory and 'antichain' otherwise, 'dense' uses one bit for every combination of presents, 'antichain' uses flat arrays bucketed by the number of presents left, 'trie' uses one bit per level, 'stride2'/'stride4' use two/four bits per level, 'zdd' shares identical sub-structures within and across cells." << std::endl;
+	std::cerr << "--engine [bfs|bidirectional|astar|idastar|bnb|beam|greedy|mitm|tablebase]: The search algorithm. 'bfs' (default) works in all modes, 'bidirectional' meets a search from the start with one from the target and only supports boards without presents, i.e. --classic, walking the board on demand instead of building the graph of all stop cells first, though on open boards both searches together still cover about half of the cells a single one would, 'astar' expands the states with the lowest bound on the solution length first, single-threaded and always with 'antichain' visited sets, 'idastar' repeats depth-first searches with an increasing bound and only needs the memory given by --ttMemory, 'bnb' searches depth-first on all threads given by --threads, cutting off everything that can not beat the best solution so far, 'beam' quickly finds good but not necessarily optimal solutions by only following the most promising states given by --beamWidth, 'greedy' walks to the nearest present again and again in the randomized runs given by --greedyRuns and takes milliseconds, 'mitm' meets a search from the start with one from the targets in the middle, joining them on cells where the two together collect all presents, 'tablebase' looks the shortest way up in a file with the number of moves left for every cell and set of presents, which it builds first if there is none, see --tablebase." << std::endl;
+	std::cerr << "--heuristic [pdb|presents]: The lower bound used by 'astar', 'idastar', 'bnb' and 'beam', where 'beam' also ranks its states by it. 'pdb' (default) uses pattern databases over groups of presents, cached in the working directory, 'presents' uses the distance for collecting each single present." << std::endl;
+	std::cerr << "--pdbGroupSize [N]: The number of presents per pattern database table, between 1 and 16, default is 6." << std::endl;
+	std::cerr << "--ttMemory [MiB]: The memory of the transposition table of 'idastar' and of the table of visited states of 'bnb', default is 1024." << std::endl;
+	std::cerr << "--maxMoves [N]: Only look for solutions with at most N moves, used by 'bnb' and 'mitm'." << std::endl;
+	std::cerr << "--beamWidth [N]: The number of states 'beam' keeps per move, default is 10000." << std::endl;
+	std::cerr << "--greedyRuns [N]: The number of randomized runs of 'greedy' and of --greedyBound, default is 1000." << std::endl;
+	std::cerr << "--greedyBound: Start 'bfs' with the solution of 'greedy' as an upper bound and drop all states that can not beat it by the distance for collecting each single present." << std::endl;
+	std::cerr << "--endgame [K]: Let 'bfs' finish every state with at most K presents left by a lookup in a table built first and drop all others that can not beat the best solution by the moves for any K of their presents. The table has one byte per cell and set of at most K presents, e.g. about 85 MiB for --christmas with K = 6." << std::endl;
+	std::cerr << "--tablebase [FILENAME]: The file of 'tablebase', default is one named after the board in the working directory. It needs one byte per cell and set of presents, about 7.5 GiB for --christmas." << std::endl;
+	std::cerr << "--denseMemory [MiB]: The memory 'auto' may use for the dense visited sets of all cells, default is 4096." << std::endl;
+}
+
+bool parseSearchEngine(std::string const& name, SearchEngine& result) {
+	if (name.compare("bfs") == 0) {
+		result = SearchEngine::BFS;
+	} else if (name.compare("bidirectional") == 0) {
+		result = SearchEngine::BIDIRECTIONAL;
+	} else if (name.compare("astar") == 0) {
+		result = SearchEngine::ASTAR;
+	} else if (name.compare("idastar") == 0) {
+		result = SearchEngine::IDASTAR;
+	} else if (name.compare("bnb") == 0) {
+		result = SearchEngine::BRANCH_AND_BOUND;
+	} else if (name.compare("beam") == 0) {
+		result = SearchEngine::BEAM;
+	} else if (name.compare("greedy") == 0) {
+		result = SearchEngine::GREEDY;
+	} else if (name.compare("mitm") == 0) {
+		result = SearchEngine::MEET_IN_THE_MIDDLE;
+	} else if (name.compare("tablebase") == 0) {
+		result = SearchEngine::TABLEBASE;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool parseHeuristicType(std::string const& name, HeuristicType& result) {
+	if (name.compare("pdb") == 0) {
+		result = HeuristicType::PATTERN_DATABASE;
+	} else if (name.compare("presents") == 0) {
+		result = HeuristicType::PRESENT_DISTANCES;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool parseVisitedSetType(std::string const& name, VisitedSetType& result) {
+	if (name.compare("auto") == 0) {
+		result = VisitedSetType::AUTO;
+	} else if (name.compare("dense") == 0) {
+		result = VisitedSetType::DENSE;
+	} else if (name.compare("trie") == 0) {
+		result = VisitedSetType::TRIE;
+	} else if (name.compare("stride2") == 0) {
+		result = VisitedSetType::STRIDE_TRIE_2;
+	} else if (name.compare("stride4") == 0) {
+		result = VisitedSetType::STRIDE_TRIE_4;
+	} else if (name.compare("antichain") == 0) {
+		result = VisitedSetType::ANTICHAIN;
+	} else if (name.compare("zdd") == 0) {
+		result = VisitedSetType::ZDD;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t playWithVisitedSet(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	// There is one visited set per stop cell of the board
+	std::size_t const stopCellCount = Board<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>::fromFieldString(fieldString, holeConnections).first.getStopCellCount();
+	std::cout << "Stop cells: " << stopCellCount << " of " << (NUM_ROWS * NUM_COLS) << std::endl;
+
+	VisitedSetType visitedSet = options.visitedSet;
+	if ((visitedSet == VisitedSetType::AUTO) && !options.stateFilename.empty() && std::filesystem::exists(options.stateFilename)) {
+		// The visited sets of a backup can only be read by the type that wrote them
+		std::string const visitedSetName = getStateBackupVisitedSet(options.stateFilename);
+		if (!parseVisitedSetType(visitedSetName, visitedSet) || (visitedSet == VisitedSetType::AUTO)) {
+			std::cerr << "The state backup '" << options.stateFilename << "' was written with the unknown visited set '" << visitedSetName << "'!" << std::endl;
+			exit(-1);
+		}
+		std::cout << "Using the visited set of the state backup: " << visitedSetName << std::endl;
+	} else if (visitedSet == VisitedSetType::AUTO) {
+		visitedSet = VisitedSetType::ANTICHAIN;
+		if constexpr(PRESENT_COUNT <= DenseVisitedSet<0>::MAX_BIT_COUNT) {
+			if (DenseVisitedSet<PRESENT_COUNT>::getMemoryRequirement(stopCellCount) <= options.denseMemoryLimit) {
+				visitedSet = VisitedSetType::DENSE;
+			}
+		}
+	}
+
+	switch (visitedSet) {
+		case VisitedSetType::DENSE:
+			if constexpr(PRESENT_COUNT <= DenseVisitedSet<0>::MAX_BIT_COUNT) {
+				std::cout << "Visited set: dense, " << (DenseVisitedSet<PRESENT_COUNT>::getMemoryRequirement(stopCellCount) / (1024 * 1024)) << " MiB at most" << std::endl;
+				return play<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, DenseVisitedSet<PRESENT_COUNT>>(fieldString, holeConnections, options);
+			} else {
+				std::cerr << "The dense visited set supports at most " << DenseVisitedSet<0>::MAX_BIT_COUNT << " presents!" << std::endl;
+				exit(-1);
+			}
+		case VisitedSetType::STRIDE_TRIE_2:
+			return play<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, StrideTrie<PRESENT_COUNT, 2>>(fieldString, holeConnections, options);
+		case VisitedSetType::STRIDE_TRIE_4:
+			return play<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, StrideTrie<PRESENT_COUNT, 4>>(fieldString, holeConnections, options);
+		case VisitedSetType::TRIE:
+			return play<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, Trie<PRESENT_COUNT>>(fieldString, holeConnections, options);
+		case VisitedSetType::ZDD:
+			return play<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, ZddSet<PRESENT_COUNT>>(fieldString, holeConnections, options);
+		case VisitedSetType::ANTICHAIN:
+		default:
+			return play<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT, AntichainSet<PRESENT_COUNT>>(fieldString, holeConnections, options);
+	}
+}
+
+template<std::size_t NUM_ROWS, std::size_t NUM_COLS, bool IS_TORUS, std::size_t PRESENT_COUNT>
+std::size_t search(std::array<std::string, NUM_ROWS> const& fieldString, std::vector<std::pair<std::size_t, std::size_t>> const& holeConnections, SearchOptions const& options) {
+	switch (options.engine) {
+		case SearchEngine::BIDIRECTIONAL:
+			return playBidirectional<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+		case SearchEngine::ASTAR:
+			return playAStar<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+		case SearchEngine::IDASTAR:
+			return playIdaStar<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+		case SearchEngine::BRANCH_AND_BOUND:
+			return playBranchAndBound<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+		case SearchEngine::BEAM:
+			return playBeam<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+		case SearchEngine::GREEDY:
+			return playNonOptimal<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+		case SearchEngine::MEET_IN_THE_MIDDLE:
+			return playMeetInTheMiddle<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+		case SearchEngine::TABLEBASE:
+			return playTablebase<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+		case SearchEngine::BFS:
+		default:
+			return playWithVisitedSet<NUM_ROWS, NUM_COLS, IS_TORUS, PRESENT_COUNT>(fieldString, holeConnections, options);
+	}
 }
 
 int main(int argc, char* argv[]) {
@@ -119,9 +202,7 @@ int main(int argc, char* argv[]) {
 	
 	PlayMode playMode = PlayMode::MODE_CLASSIC;
 	std::string turnsToPlay;
-	std::string backupName;
-	bool deleteOldBackups = false;
-	bool noBackups = false;
+	SearchOptions options;
 
 	if (argc > 1) {
 		for (std::size_t i = 1; i < argc; ++i) {
@@ -144,11 +225,138 @@ int main(int argc, char* argv[]) {
 					return -1;
 				}
 				++i;
-				backupName = argv[i];
+				options.stateFilename = argv[i];
 			} else if (arg.compare("--deleteOldBackups") == 0) {
-				deleteOldBackups = true;
+				options.deleteOldBackups = true;
 			} else if (arg.compare("--noBackups") == 0) {
-				noBackups = true;
+				options.noBackups = true;
+			} else if (arg.compare("--threads") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--threads' expects the number of threads to be given, e.g. '--threads 8'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.threadCount = std::strtoull(argv[i], nullptr, 10);
+				if (options.threadCount == 0) {
+					std::cerr << "The option '--threads' expects a positive number of threads, got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--visited") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--visited' expects the structure to be given, e.g. '--visited stride4'!" << std::endl;
+					return -1;
+				}
+				++i;
+				if (!parseVisitedSetType(argv[i], options.visitedSet)) {
+					std::cerr << "The option '--visited' expects one of 'auto', 'dense', 'antichain', 'trie', 'stride2', 'stride4' or 'zdd', got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--engine") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--engine' expects the search algorithm to be given, e.g. '--engine bidirectional'!" << std::endl;
+					return -1;
+				}
+				++i;
+				if (!parseSearchEngine(argv[i], options.engine)) {
+					std::cerr << "The option '--engine' expects one of 'bfs', 'bidirectional', 'astar', 'idastar', 'bnb', 'beam', 'greedy', 'mitm' or 'tablebase', got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--heuristic") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--heuristic' expects the lower bound to be given, e.g. '--heuristic pdb'!" << std::endl;
+					return -1;
+				}
+				++i;
+				if (!parseHeuristicType(argv[i], options.heuristic)) {
+					std::cerr << "The option '--heuristic' expects one of 'pdb' or 'presents', got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--pdbGroupSize") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--pdbGroupSize' expects the number of presents per table to be given, e.g. '--pdbGroupSize 8'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.pdbGroupSize = std::strtoull(argv[i], nullptr, 10);
+				if ((options.pdbGroupSize < 1) || (options.pdbGroupSize > 16)) {
+					std::cerr << "The option '--pdbGroupSize' expects a number between 1 and 16, got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--ttMemory") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--ttMemory' expects the memory in MiB to be given, e.g. '--ttMemory 4096'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.transpositionTableMemory = std::strtoull(argv[i], nullptr, 10) * 1024 * 1024;
+				if (options.transpositionTableMemory == 0) {
+					std::cerr << "The option '--ttMemory' expects a positive amount of memory in MiB, got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--maxMoves") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--maxMoves' expects the number of moves to be given, e.g. '--maxMoves 100'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.maxMoves = std::strtoull(argv[i], nullptr, 10);
+				if (options.maxMoves == 0) {
+					std::cerr << "The option '--maxMoves' expects a positive number of moves, got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--beamWidth") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--beamWidth' expects the number of states to be given, e.g. '--beamWidth 100000'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.beamWidth = std::strtoull(argv[i], nullptr, 10);
+				if (options.beamWidth == 0) {
+					std::cerr << "The option '--beamWidth' expects a positive number of states, got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--greedyRuns") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--greedyRuns' expects the number of runs to be given, e.g. '--greedyRuns 10000'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.greedyRuns = std::strtoull(argv[i], nullptr, 10);
+				if (options.greedyRuns == 0) {
+					std::cerr << "The option '--greedyRuns' expects a positive number of runs, got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--greedyBound") == 0) {
+				options.useGreedyBound = true;
+			} else if (arg.compare("--endgame") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--endgame' expects the number of presents left to be given, e.g. '--endgame 6'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.endgamePresentCount = std::strtoull(argv[i], nullptr, 10);
+				if (options.endgamePresentCount == 0) {
+					std::cerr << "The option '--endgame' expects a positive number of presents, got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
+			} else if (arg.compare("--tablebase") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--tablebase' expects the filename to be given, e.g. '--tablebase christmas.tablebase.bin'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.tablebaseFilename = argv[i];
+			} else if (arg.compare("--denseMemory") == 0) {
+				if (!hasOneMore) {
+					std::cerr << "The option '--denseMemory' expects the memory in MiB to be given, e.g. '--denseMemory 8192'!" << std::endl;
+					return -1;
+				}
+				++i;
+				options.denseMemoryLimit = std::strtoull(argv[i], nullptr, 10) * 1024 * 1024;
+				if (options.denseMemoryLimit == 0) {
+					std::cerr << "The option '--denseMemory' expects a positive amount of memory in MiB, got '" << argv[i] << "'!" << std::endl;
+					return -1;
+				}
 			} else if (arg.compare("--help") == 0) {
 				printHelp();
 				return 0;
@@ -163,12 +371,20 @@ int main(int argc, char* argv[]) {
 		return 0;
 	}
 
+	// The tablebase finishes the position the given moves lead to, instead of only playing them
+	if (options.engine == SearchEngine::TABLEBASE) {
+		options.startingMoves = turnsToPlay;
+		turnsToPlay.clear();
+	}
+
 	std::cout << "Playing in mode: " << ((playMode == PlayMode::MODE_CLASSIC) ? "Classic" : "Christmas") << std::endl;
-	std::cout << "Make backups: " << ((noBackups) ? "no" : "yes") << std::endl;
-	std::cout << "Delete old backups: " << ((deleteOldBackups) ? "yes" : "no") << std::endl;
+	std::cout << "Make backups: " << ((options.noBackups) ? "no" : "yes") << std::endl;
+	std::cout << "Delete old backups: " << ((options.deleteOldBackups) ? "yes" : "no") << std::endl;
 	if (turnsToPlay.empty()) {
 		std::cout << "Performing search." << std::endl;
-		std::cout << "Restarting from backup: " << ((backupName.empty()) ? "no" : "yes") << std::endl;
+		std::cout << "Restarting from backup: " << ((options.stateFilename.empty()) ? "no" : "yes") << std::endl;
+		std::cout << "Threads: " << options.threadCount << std::endl;
+		std::cout << "Subset scan: " << getSubsetScanName(subsetScanKind) << std::endl;
 	} else {
 		std::cout << "Playing given moves." << std::endl;
 	}
@@ -177,13 +393,13 @@ int main(int argc, char* argv[]) {
 	std::size_t combinations = 0;
 	if (playMode == PlayMode::MODE_CLASSIC) {
 		if (turnsToPlay.empty()) {
-			combinations = play<20, 20, false, 0>(fieldStringBasic, holeConnectionsBasic, deleteOldBackups, noBackups, backupName);
+			combinations = search<20, 20, false, 0>(fieldStringBasic, holeConnectionsBasic, options);
 		} else {
 			combinations = playString<20, 20, false, 0>(fieldStringBasic, holeConnectionsBasic, turnsToPlay);
 		}
 	} else {
 		if (turnsToPlay.empty()) {
-			combinations = play<40, 40, true, 24>(fieldStringChristmas, holeConnectionsChristmas, deleteOldBackups, noBackups, backupName);
+			combinations = search<40, 40, true, 24>(fieldStringChristmas, holeConnectionsChristmas, options);
 		} else {
 			combinations = playString<40, 40, true, 24>(fieldStringChristmas, holeConnectionsChristmas, turnsToPlay);
 		}